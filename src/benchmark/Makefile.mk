@@ -0,0 +1,35 @@
+## Benchmark runner, it is not built by default, use 'make bench'
+
+bench_CPPFLAGS = \
+-I. \
+-I$(top_srcdir)/src/lib \
+-I$(top_srcdir)/src/lib/renderer \
+-I$(top_srcdir)/src/lib/object \
+@ENESIM_CFLAGS@
+
+bench_LDADD = \
+$(top_builddir)/src/lib/libenesim.la \
+@ENESIM_LIBS@ \
+-lm
+
+EXTRA_PROGRAMS = src/benchmark/enesim_bench
+
+src_benchmark_enesim_bench_SOURCES = \
+src/benchmark/enesim_bench.c \
+src/benchmark/enesim_bench.h \
+src/benchmark/enesim_bench_compositor.c \
+src/benchmark/enesim_bench_converter.c \
+src/benchmark/enesim_bench_image.c \
+src/benchmark/enesim_bench_path.c \
+src/benchmark/enesim_bench_renderer.c \
+src/benchmark/enesim_bench_threads.c
+src_benchmark_enesim_bench_CPPFLAGS = $(bench_CPPFLAGS)
+src_benchmark_enesim_bench_LDADD = $(bench_LDADD)
+
+CLEAN_LOCAL += src/benchmark/enesim_bench$(EXEEXT)
+
+# Extra arguments for the runner, like: make bench BENCH_ARGS="-i 50 renderer"
+BENCH_ARGS =
+
+bench: src/benchmark/enesim_bench$(EXEEXT)
+	$(top_builddir)/src/benchmark/enesim_bench$(EXEEXT) $(BENCH_ARGS)
@@ -0,0 +1,339 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_bench.h"
+
+#include <math.h>
+#include <unistd.h>
+
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+typedef struct _Enesim_Bench_Suite_Description
+{
+	const char *name;
+	Enesim_Bench_Suite run;
+	/* run the suite once per thread count */
+	Eina_Bool thread_sweep;
+} Enesim_Bench_Suite_Description;
+
+typedef struct _Enesim_Bench_Renderer_Data
+{
+	Enesim_Renderer *r;
+	Enesim_Surface *s;
+	Enesim_Rop rop;
+	Enesim_Log *log;
+} Enesim_Bench_Renderer_Data;
+
+static Enesim_Bench_Suite_Description suites[] = {
+	{ "compositor", enesim_bench_compositor, EINA_FALSE },
+	{ "renderer", enesim_bench_renderer, EINA_FALSE },
+	{ "path", enesim_bench_path, EINA_FALSE },
+	{ "image", enesim_bench_image, EINA_FALSE },
+	{ "threads", enesim_bench_threads, EINA_TRUE },
+	{ "converter", enesim_bench_converter, EINA_TRUE },
+};
+
+static inline uint64_t _bench_time_get(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return ((uint64_t)t.tv_sec * 1000000000ULL) + t.tv_nsec;
+}
+
+static int _bench_time_cmp(const void *a, const void *b)
+{
+	uint64_t ta = *(const uint64_t *)a;
+	uint64_t tb = *(const uint64_t *)b;
+
+	if (ta < tb) return -1;
+	if (ta > tb) return 1;
+	return 0;
+}
+
+static Eina_Bool _bench_renderer_draw(void *data)
+{
+	Enesim_Bench_Renderer_Data *thiz = data;
+
+	if (!enesim_renderer_draw(thiz->r, thiz->s, thiz->rop, NULL, 0, 0,
+			&thiz->log))
+	{
+		enesim_log_dump(thiz->log);
+		enesim_log_unref(thiz->log);
+		thiz->log = NULL;
+		return EINA_FALSE;
+	}
+	return EINA_TRUE;
+}
+
+static void _bench_header(FILE *out)
+{
+	fprintf(out, "suite,name,params,threads,pixels,iterations,"
+			"min_ns,median_ns,mean_ns,stddev_ns,max_ns,"
+			"ns_per_pixel,mpix_per_s\n");
+}
+
+static void help(const char *name)
+{
+	unsigned int i;
+
+	printf("Usage: %s [OPTIONS] [SUITE...]\n", name);
+	printf("Where OPTIONS can be:\n");
+	printf(" -i ITERATIONS  Number of timed runs (default 20)\n");
+	printf(" -w WARMUP      Number of untimed runs (default 3)\n");
+	printf(" -f FILTER      Only run benchmarks whose name contains FILTER\n");
+	printf(" -t THREADS     Comma separated thread counts for the "
+			"threads suite (default 1,2,4,...,ncpus)\n");
+	printf(" -o FILE        Write the results into FILE instead of stdout\n");
+	printf(" -d DIR         Directory for temporary files (default /tmp)\n");
+	printf("Where SUITE can be one of the following:\n");
+	for (i = 0; i < sizeof(suites) / sizeof(Enesim_Bench_Suite_Description); i++)
+		printf("- %s\n", suites[i].name);
+}
+
+static int _bench_threads_parse(const char *str, int *threads, int max)
+{
+	char *tmp;
+	char *tok;
+	char *saveptr = NULL;
+	int count = 0;
+
+	tmp = strdup(str);
+	for (tok = strtok_r(tmp, ",", &saveptr); tok && count < max;
+			tok = strtok_r(NULL, ",", &saveptr))
+	{
+		int n = atoi(tok);
+		if (n > 0)
+			threads[count++] = n;
+	}
+	free(tmp);
+	return count;
+}
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+void enesim_bench_run(Enesim_Bench_Options *options, const char *suite,
+		const char *name, const char *params, size_t pixels,
+		Enesim_Bench_Run cb, void *data)
+{
+	uint64_t *times;
+	double mean = 0;
+	double stddev = 0;
+	uint64_t median;
+	int i;
+
+	if (options->filter && !strstr(name, options->filter))
+		return;
+
+	for (i = 0; i < options->warmup; i++)
+	{
+		if (!cb(data))
+		{
+			fprintf(stderr, "Benchmark '%s' (%s) failed\n", name, params);
+			return;
+		}
+	}
+
+	times = malloc(sizeof(uint64_t) * options->iterations);
+	for (i = 0; i < options->iterations; i++)
+	{
+		uint64_t t0, t1;
+
+		t0 = _bench_time_get();
+		if (!cb(data))
+		{
+			fprintf(stderr, "Benchmark '%s' (%s) failed\n", name, params);
+			free(times);
+			return;
+		}
+		t1 = _bench_time_get();
+		times[i] = t1 - t0;
+		mean += times[i];
+	}
+	mean /= options->iterations;
+	for (i = 0; i < options->iterations; i++)
+		stddev += (times[i] - mean) * (times[i] - mean);
+	stddev = sqrt(stddev / options->iterations);
+
+	qsort(times, options->iterations, sizeof(uint64_t), _bench_time_cmp);
+	median = times[options->iterations / 2];
+
+	fprintf(options->out, "%s,%s,%s,%d,%zu,%d,"
+			"%" PRIu64 ",%" PRIu64 ",%.0f,%.0f,%" PRIu64 ",%.3f,%.3f\n",
+			suite, name, params ? params : "", options->threads,
+			pixels, options->iterations,
+			times[0], median, mean, stddev,
+			times[options->iterations - 1],
+			pixels ? (double)median / pixels : 0.0,
+			median ? (pixels * 1000.0) / median : 0.0);
+	fflush(options->out);
+	free(times);
+}
+
+void enesim_bench_renderer_run(Enesim_Bench_Options *options,
+		const char *suite, const char *name, const char *params,
+		Enesim_Renderer *r, Enesim_Surface *s, Enesim_Rop rop)
+{
+	Enesim_Bench_Renderer_Data data;
+	int w, h;
+
+	data.r = r;
+	data.s = s;
+	data.rop = rop;
+	data.log = NULL;
+
+	enesim_surface_size_get(s, &w, &h);
+	enesim_bench_run(options, suite, name, params, (size_t)w * h,
+			_bench_renderer_draw, &data);
+}
+
+int main(int argc, char **argv)
+{
+	Enesim_Bench_Options options;
+	const char *output = NULL;
+	const char *threads_str = NULL;
+	int threads[64];
+	int nthreads = 0;
+	int opt;
+	unsigned int i;
+	int j;
+
+	options.warmup = 3;
+	options.iterations = 20;
+	options.filter = NULL;
+	options.tmpdir = "/tmp";
+	options.out = stdout;
+	options.threads = 0;
+
+	while ((opt = getopt(argc, argv, "i:w:f:t:o:d:h")) != -1)
+	{
+		switch (opt)
+		{
+			case 'i':
+			options.iterations = atoi(optarg);
+			break;
+
+			case 'w':
+			options.warmup = atoi(optarg);
+			break;
+
+			case 'f':
+			options.filter = optarg;
+			break;
+
+			case 't':
+			threads_str = optarg;
+			break;
+
+			case 'o':
+			output = optarg;
+			break;
+
+			case 'd':
+			options.tmpdir = optarg;
+			break;
+
+			default:
+			help(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+	if (options.iterations < 1 || options.warmup < 0)
+	{
+		help(argv[0]);
+		return 1;
+	}
+
+	if (output)
+	{
+		options.out = fopen(output, "w");
+		if (!options.out)
+		{
+			fprintf(stderr, "Can not open '%s' for writing\n", output);
+			return 1;
+		}
+	}
+
+	eina_init();
+	/* the thread counts to sweep */
+	if (threads_str)
+	{
+		nthreads = _bench_threads_parse(threads_str, threads, 64);
+	}
+	else
+	{
+		int n;
+
+		for (n = 1; n < eina_cpu_count() && nthreads < 63; n *= 2)
+			threads[nthreads++] = n;
+		threads[nthreads++] = eina_cpu_count();
+	}
+
+	_bench_header(options.out);
+	for (i = 0; i < sizeof(suites) / sizeof(Enesim_Bench_Suite_Description); i++)
+	{
+		Enesim_Bench_Suite_Description *d = &suites[i];
+
+		/* only run the requested suites */
+		if (optind < argc)
+		{
+			Eina_Bool found = EINA_FALSE;
+
+			for (j = optind; j < argc; j++)
+			{
+				if (!strcmp(argv[j], d->name))
+				{
+					found = EINA_TRUE;
+					break;
+				}
+			}
+			if (!found) continue;
+		}
+
+		if (!d->thread_sweep)
+		{
+			options.threads = 0;
+			enesim_init();
+			d->run(&options);
+			enesim_shutdown();
+			continue;
+		}
+
+		/* the number of threads is read at init time, so we need a
+		 * complete init/shutdown cycle for every count
+		 */
+		for (j = 0; j < nthreads; j++)
+		{
+			char str[16];
+
+			snprintf(str, sizeof(str), "%d", threads[j]);
+			setenv("ENESIM_CPU_COUNT", str, 1);
+			options.threads = threads[j];
+			enesim_init();
+			d->run(&options);
+			enesim_shutdown();
+		}
+		unsetenv("ENESIM_CPU_COUNT");
+	}
+	eina_shutdown();
+
+	if (output)
+		fclose(options.out);
+
+	return 0;
+}
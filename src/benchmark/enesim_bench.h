@@ -0,0 +1,71 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _ENESIM_BENCH_H
+#define _ENESIM_BENCH_H
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define _GNU_SOURCE 1
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Enesim.h"
+
+typedef struct _Enesim_Bench_Options
+{
+	/* number of untimed runs before measuring */
+	int warmup;
+	/* number of timed runs */
+	int iterations;
+	/* only run the benchmarks whose name contains this string */
+	const char *filter;
+	/* directory to write temporary files into */
+	const char *tmpdir;
+	/* where to emit the results */
+	FILE *out;
+	/* current number of threads used for drawing */
+	int threads;
+} Enesim_Bench_Options;
+
+/* A single measurable operation */
+typedef Eina_Bool (*Enesim_Bench_Run)(void *data);
+
+/* every suite must implement this */
+typedef void (*Enesim_Bench_Suite)(Enesim_Bench_Options *options);
+
+/* The runner */
+void enesim_bench_run(Enesim_Bench_Options *options, const char *suite,
+		const char *name, const char *params, size_t pixels,
+		Enesim_Bench_Run cb, void *data);
+void enesim_bench_renderer_run(Enesim_Bench_Options *options,
+		const char *suite, const char *name, const char *params,
+		Enesim_Renderer *r, Enesim_Surface *s, Enesim_Rop rop);
+
+/* The different suites */
+void enesim_bench_compositor(Enesim_Bench_Options *options);
+void enesim_bench_renderer(Enesim_Bench_Options *options);
+void enesim_bench_path(Enesim_Bench_Options *options);
+void enesim_bench_threads(Enesim_Bench_Options *options);
+void enesim_bench_image(Enesim_Bench_Options *options);
+void enesim_bench_converter(Enesim_Bench_Options *options);
+
+#endif
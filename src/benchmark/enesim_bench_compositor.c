@@ -0,0 +1,145 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_bench.h"
+
+/* The compositor spans are not exported, so we reach every registered
+ * span through the renderers that request them: the background renderer
+ * uses the color and mask/color spans, the image renderer through the
+ * software core uses the pixel, pixel/color and pixel/mask spans
+ */
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+#define BENCH_COMPOSITOR_WIDTH 1024
+#define BENCH_COMPOSITOR_HEIGHT 256
+
+typedef struct _Enesim_Bench_Compositor_Mask
+{
+	const char *name;
+	Eina_Bool enabled;
+	Enesim_Channel channel;
+} Enesim_Bench_Compositor_Mask;
+
+static Enesim_Bench_Compositor_Mask masks[] = {
+	{ "none", EINA_FALSE, ENESIM_CHANNEL_ALPHA },
+	{ "alpha", EINA_TRUE, ENESIM_CHANNEL_ALPHA },
+	{ "luminance", EINA_TRUE, ENESIM_CHANNEL_LUMINANCE },
+};
+
+static Enesim_Color colors[] = {
+	0xffffffff,
+	0x80808080,
+};
+
+static Enesim_Renderer * _compositor_mask_new(void)
+{
+	Enesim_Renderer *r;
+	Enesim_Renderer_Gradient_Stop stop;
+
+	r = enesim_renderer_gradient_linear_new();
+	enesim_renderer_gradient_linear_position_set(r, 0, 0,
+			BENCH_COMPOSITOR_WIDTH, 0);
+	stop.argb = 0xffffffff;
+	stop.pos = 0;
+	enesim_renderer_gradient_stop_add(r, &stop);
+	stop.argb = 0x00000000;
+	stop.pos = 1;
+	enesim_renderer_gradient_stop_add(r, &stop);
+	return r;
+}
+
+static Enesim_Surface * _compositor_source_new(void)
+{
+	Enesim_Renderer *r;
+	Enesim_Surface *s;
+
+	/* a semi transparent source, to avoid any opaque shortcut */
+	r = enesim_renderer_checker_new();
+	enesim_renderer_checker_even_color_set(r, 0x80800000);
+	enesim_renderer_checker_odd_color_set(r, 0xff00ff00);
+	enesim_renderer_checker_width_set(r, 16);
+	enesim_renderer_checker_height_set(r, 16);
+
+	s = enesim_surface_new(ENESIM_FORMAT_ARGB8888, BENCH_COMPOSITOR_WIDTH,
+			BENCH_COMPOSITOR_HEIGHT);
+	enesim_renderer_draw(r, s, ENESIM_ROP_FILL, NULL, 0, 0, NULL);
+	enesim_renderer_unref(r);
+
+	return s;
+}
+
+static void _compositor_run(Enesim_Bench_Options *options,
+		const char *name, Enesim_Renderer *r, Enesim_Surface *dst)
+{
+	Enesim_Renderer *mask;
+	unsigned int i, j;
+	int rop;
+
+	mask = _compositor_mask_new();
+	for (rop = 0; rop < ENESIM_ROP_LAST; rop++)
+	{
+		for (i = 0; i < sizeof(colors) / sizeof(Enesim_Color); i++)
+		{
+			for (j = 0; j < sizeof(masks) / sizeof(Enesim_Bench_Compositor_Mask); j++)
+			{
+				char params[PATH_MAX];
+
+				enesim_renderer_color_set(r, colors[i]);
+				enesim_renderer_mask_set(r, masks[j].enabled ?
+						enesim_renderer_ref(mask) : NULL);
+				enesim_renderer_mask_channel_set(r, masks[j].channel);
+				snprintf(params, sizeof(params),
+						"rop=%s color=%08x mask=%s",
+						rop == ENESIM_ROP_FILL ? "fill" : "blend",
+						colors[i], masks[j].name);
+				enesim_bench_renderer_run(options, "compositor", name,
+						params, r, dst, rop);
+			}
+		}
+	}
+	enesim_renderer_mask_set(r, NULL);
+	enesim_renderer_unref(mask);
+}
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+void enesim_bench_compositor(Enesim_Bench_Options *options)
+{
+	Enesim_Renderer *r;
+	Enesim_Surface *src;
+	Enesim_Surface *dst;
+
+	dst = enesim_surface_new(ENESIM_FORMAT_ARGB8888, BENCH_COMPOSITOR_WIDTH,
+			BENCH_COMPOSITOR_HEIGHT);
+	/* color source */
+	r = enesim_renderer_background_new();
+	enesim_renderer_background_color_set(r, 0xc0c00000);
+	_compositor_run(options, "color", r, dst);
+	enesim_renderer_unref(r);
+
+	/* pixel source */
+	src = _compositor_source_new();
+	r = enesim_renderer_image_new();
+	enesim_renderer_image_source_surface_set(r, src);
+	enesim_renderer_image_size_set(r, BENCH_COMPOSITOR_WIDTH,
+			BENCH_COMPOSITOR_HEIGHT);
+	_compositor_run(options, "pixel", r, dst);
+	enesim_renderer_unref(r);
+
+	enesim_surface_unref(dst);
+}
@@ -0,0 +1,157 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_bench.h"
+
+/* Conversion of a rendered frame into the formats used by the displays.
+ * Like the threads suite it is run for every thread count, as the big
+ * conversions are split between the worker threads. The drawing of a
+ * frame into a RGB565 buffer is also compared, rendering into a surface
+ * and converting it against converting every span while rendering
+ */
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+typedef struct _Enesim_Bench_Converter_Format
+{
+	const char *name;
+	Enesim_Buffer_Format format;
+} Enesim_Bench_Converter_Format;
+
+typedef struct _Enesim_Bench_Converter_Data
+{
+	Enesim_Buffer *src;
+	Enesim_Buffer *dst;
+	Enesim_Renderer *r;
+	Enesim_Surface *s;
+} Enesim_Bench_Converter_Data;
+
+static Enesim_Bench_Converter_Format formats[] = {
+	{ "argb8888", ENESIM_BUFFER_FORMAT_ARGB8888 },
+	{ "xrgb8888", ENESIM_BUFFER_FORMAT_XRGB8888 },
+	{ "rgb888", ENESIM_BUFFER_FORMAT_RGB888 },
+	{ "bgr888", ENESIM_BUFFER_FORMAT_BGR888 },
+	{ "rgb565", ENESIM_BUFFER_FORMAT_RGB565 },
+};
+
+static int sizes[] = { 256, 1024, 2048 };
+
+static Enesim_Renderer * _converter_renderer_new(void)
+{
+	Enesim_Renderer *r;
+
+	/* translucent pixels so the unpremultiply does its work */
+	r = enesim_renderer_checker_new();
+	enesim_renderer_checker_width_set(r, 16);
+	enesim_renderer_checker_height_set(r, 16);
+	enesim_renderer_checker_even_color_set(r, 0x80402010);
+	enesim_renderer_checker_odd_color_set(r, 0xff0000ff);
+
+	return r;
+}
+
+static Enesim_Buffer * _converter_buffer_new(int size)
+{
+	Enesim_Renderer *r;
+	Enesim_Surface *s;
+	Enesim_Buffer *b;
+
+	r = _converter_renderer_new();
+	s = enesim_surface_new(ENESIM_FORMAT_ARGB8888, size, size);
+	enesim_renderer_draw(r, s, ENESIM_ROP_FILL, NULL, 0, 0, NULL);
+	enesim_renderer_unref(r);
+	b = enesim_surface_buffer_get(s);
+	enesim_surface_unref(s);
+
+	return b;
+}
+
+static Eina_Bool _converter_convert(void *data)
+{
+	Enesim_Bench_Converter_Data *thiz = data;
+
+	return enesim_buffer_convert(thiz->src, thiz->dst);
+}
+
+static Eina_Bool _converter_draw_two_pass(void *data)
+{
+	Enesim_Bench_Converter_Data *thiz = data;
+
+	if (!enesim_renderer_draw(thiz->r, thiz->s, ENESIM_ROP_FILL, NULL, 0, 0,
+			NULL))
+		return EINA_FALSE;
+	return enesim_surface_convert(thiz->s, thiz->dst);
+}
+
+static Eina_Bool _converter_draw_fused(void *data)
+{
+	Enesim_Bench_Converter_Data *thiz = data;
+
+	return enesim_renderer_draw_buffer_list(thiz->r, thiz->dst, NULL, 0, 0,
+			NULL);
+}
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+void enesim_bench_converter(Enesim_Bench_Options *options)
+{
+	unsigned int i, j;
+
+	for (i = 0; i < sizeof(sizes) / sizeof(int); i++)
+	{
+		Enesim_Bench_Converter_Data data;
+		char params[PATH_MAX];
+
+		data.src = _converter_buffer_new(sizes[i]);
+		snprintf(params, sizeof(params), "size=%d", sizes[i]);
+		for (j = 0; j < sizeof(formats) / sizeof(Enesim_Bench_Converter_Format); j++)
+		{
+			data.dst = enesim_buffer_new(formats[j].format, sizes[i],
+					sizes[i]);
+			/* first check that the converter exists */
+			if (!data.dst || !_converter_convert(&data))
+			{
+				fprintf(stderr, "Converter to '%s' not available\n",
+						formats[j].name);
+				if (data.dst)
+					enesim_buffer_unref(data.dst);
+				continue;
+			}
+			enesim_bench_run(options, "converter", formats[j].name,
+					params, (size_t)sizes[i] * sizes[i],
+					_converter_convert, &data);
+			enesim_buffer_unref(data.dst);
+		}
+		enesim_buffer_unref(data.src);
+
+		/* the whole frame drawn into a 16 bits framebuffer */
+		data.r = _converter_renderer_new();
+		data.s = enesim_surface_new(ENESIM_FORMAT_ARGB8888, sizes[i],
+				sizes[i]);
+		data.dst = enesim_buffer_new(ENESIM_BUFFER_FORMAT_RGB565,
+				sizes[i], sizes[i]);
+		enesim_bench_run(options, "converter", "draw_rgb565_two_pass",
+				params, (size_t)sizes[i] * sizes[i],
+				_converter_draw_two_pass, &data);
+		enesim_bench_run(options, "converter", "draw_rgb565_fused",
+				params, (size_t)sizes[i] * sizes[i],
+				_converter_draw_fused, &data);
+		enesim_buffer_unref(data.dst);
+		enesim_surface_unref(data.s);
+		enesim_renderer_unref(data.r);
+	}
+}
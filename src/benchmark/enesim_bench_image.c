@@ -0,0 +1,137 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_bench.h"
+
+#include <unistd.h>
+
+/* Encoding and decoding through every image provider we know of. The
+ * images are generated first, in case a provider is not available the
+ * save fails and the provider is skipped
+ */
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+typedef struct _Enesim_Bench_Image_Codec
+{
+	const char *name;
+	const char *extension;
+} Enesim_Bench_Image_Codec;
+
+typedef struct _Enesim_Bench_Image_Data
+{
+	const char *file;
+	Enesim_Buffer *buffer;
+} Enesim_Bench_Image_Data;
+
+static Enesim_Bench_Image_Codec codecs[] = {
+	{ "png", "png" },
+	{ "jpg", "jpg" },
+};
+
+static int sizes[] = { 64, 512, 2048 };
+
+static Enesim_Buffer * _image_buffer_new(int size)
+{
+	Enesim_Renderer *r;
+	Enesim_Renderer_Gradient_Stop stop;
+	Enesim_Surface *s;
+	Enesim_Buffer *b;
+
+	/* a gradient has enough detail to not be trivially compressed */
+	r = enesim_renderer_gradient_radial_new();
+	enesim_renderer_gradient_radial_center_set(r, size / 2, size / 2);
+	enesim_renderer_gradient_radial_radius_set(r, size / 7);
+	enesim_renderer_gradient_repeat_mode_set(r, ENESIM_REPEAT_MODE_REFLECT);
+	stop.argb = 0xffff0000;
+	stop.pos = 0;
+	enesim_renderer_gradient_stop_add(r, &stop);
+	stop.argb = 0xff0000ff;
+	stop.pos = 1;
+	enesim_renderer_gradient_stop_add(r, &stop);
+
+	s = enesim_surface_new(ENESIM_FORMAT_ARGB8888, size, size);
+	enesim_renderer_draw(r, s, ENESIM_ROP_FILL, NULL, 0, 0, NULL);
+	enesim_renderer_unref(r);
+	b = enesim_surface_buffer_get(s);
+	enesim_surface_unref(s);
+
+	return b;
+}
+
+static Eina_Bool _image_save(void *data)
+{
+	Enesim_Bench_Image_Data *thiz = data;
+
+	return enesim_image_file_save(thiz->file, thiz->buffer, NULL, NULL);
+}
+
+static Eina_Bool _image_load(void *data)
+{
+	Enesim_Bench_Image_Data *thiz = data;
+	Enesim_Buffer *b = NULL;
+
+	if (!enesim_image_file_load(thiz->file, &b, NULL, NULL, NULL))
+		return EINA_FALSE;
+	enesim_buffer_unref(b);
+	return EINA_TRUE;
+}
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+void enesim_bench_image(Enesim_Bench_Options *options)
+{
+	unsigned int i, j;
+
+	for (i = 0; i < sizeof(sizes) / sizeof(int); i++)
+	{
+		Enesim_Buffer *b;
+
+		b = _image_buffer_new(sizes[i]);
+		for (j = 0; j < sizeof(codecs) / sizeof(Enesim_Bench_Image_Codec); j++)
+		{
+			Enesim_Bench_Image_Data data;
+			char file[PATH_MAX];
+			char name[PATH_MAX];
+			char params[PATH_MAX];
+
+			snprintf(file, sizeof(file), "%s/enesim_bench_%d.%s",
+					options->tmpdir, sizes[i],
+					codecs[j].extension);
+			data.file = file;
+			data.buffer = b;
+			/* first check that the provider exists */
+			if (!_image_save(&data))
+			{
+				fprintf(stderr, "Codec '%s' not available\n",
+						codecs[j].name);
+				continue;
+			}
+			snprintf(params, sizeof(params), "size=%d", sizes[i]);
+			snprintf(name, sizeof(name), "%s_save", codecs[j].name);
+			enesim_bench_run(options, "image", name, params,
+					(size_t)sizes[i] * sizes[i],
+					_image_save, &data);
+			snprintf(name, sizeof(name), "%s_load", codecs[j].name);
+			enesim_bench_run(options, "image", name, params,
+					(size_t)sizes[i] * sizes[i],
+					_image_load, &data);
+			unlink(file);
+		}
+		enesim_buffer_unref(b);
+	}
+}
@@ -0,0 +1,122 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_bench.h"
+
+#include <math.h>
+
+/* Complexity sweeps for the path rasterizer (kiia). Every path is a star
+ * polygon with a variable number of vertices, optionally built with cubic
+ * curves, so the number of edges and crossings grows with the complexity
+ */
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+#define BENCH_PATH_SIZE 512
+
+static int complexities[] = { 8, 64, 512, 4096 };
+
+static Enesim_Path * _path_star_new(int vertices, Eina_Bool curves)
+{
+	Enesim_Path *p;
+	double cx = BENCH_PATH_SIZE / 2;
+	double cy = BENCH_PATH_SIZE / 2;
+	double r0 = BENCH_PATH_SIZE * 0.45;
+	double r1 = BENCH_PATH_SIZE * 0.15;
+	int i;
+
+	p = enesim_path_new();
+	enesim_path_move_to(p, cx + r0, cy);
+	for (i = 1; i <= vertices; i++)
+	{
+		double a = (2 * M_PI * i) / vertices;
+		double r = (i % 2) ? r1 : r0;
+		double x = cx + r * cos(a);
+		double y = cy + r * sin(a);
+
+		if (curves)
+		{
+			double ah = (2 * M_PI * (i - 0.5)) / vertices;
+
+			enesim_path_cubic_to(p,
+					cx + r0 * cos(ah), cy + r1 * sin(ah),
+					cx + r1 * cos(ah), cy + r0 * sin(ah),
+					x, y);
+		}
+		else
+		{
+			enesim_path_line_to(p, x, y);
+		}
+	}
+	enesim_path_close(p);
+
+	return p;
+}
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+void enesim_bench_path(Enesim_Bench_Options *options)
+{
+	Enesim_Surface *s;
+	unsigned int i;
+	int curves;
+	int rule;
+	int mode;
+
+	s = enesim_surface_new(ENESIM_FORMAT_ARGB8888, BENCH_PATH_SIZE,
+			BENCH_PATH_SIZE);
+	for (i = 0; i < sizeof(complexities) / sizeof(int); i++)
+	{
+		for (curves = 0; curves < 2; curves++)
+		{
+			for (rule = 0; rule < 2; rule++)
+			{
+				for (mode = ENESIM_RENDERER_SHAPE_DRAW_MODE_FILL;
+						mode <= ENESIM_RENDERER_SHAPE_DRAW_MODE_STROKE_FILL;
+						mode++)
+				{
+					Enesim_Renderer *r;
+					char params[PATH_MAX];
+
+					r = enesim_renderer_path_new();
+					enesim_renderer_path_inner_path_set(r,
+							_path_star_new(complexities[i], curves));
+					enesim_renderer_shape_fill_rule_set(r, rule ?
+							ENESIM_RENDERER_SHAPE_FILL_RULE_EVEN_ODD :
+							ENESIM_RENDERER_SHAPE_FILL_RULE_NON_ZERO);
+					enesim_renderer_shape_fill_color_set(r, 0xffff0000);
+					enesim_renderer_shape_stroke_color_set(r, 0xff0000ff);
+					enesim_renderer_shape_stroke_weight_set(r, 2);
+					enesim_renderer_shape_draw_mode_set(r, mode);
+
+					snprintf(params, sizeof(params),
+							"vertices=%d segments=%s rule=%s mode=%s",
+							complexities[i],
+							curves ? "cubic" : "line",
+							rule ? "evenodd" : "nonzero",
+							mode == ENESIM_RENDERER_SHAPE_DRAW_MODE_FILL ? "fill" :
+							mode == ENESIM_RENDERER_SHAPE_DRAW_MODE_STROKE ? "stroke" :
+							"strokefill");
+					enesim_bench_renderer_run(options, "path", "kiia",
+							params, r, s, ENESIM_ROP_FILL);
+					enesim_renderer_unref(r);
+				}
+			}
+		}
+	}
+	enesim_surface_unref(s);
+}
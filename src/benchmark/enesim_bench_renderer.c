@@ -0,0 +1,345 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_bench.h"
+
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+typedef Enesim_Renderer * (*Enesim_Bench_Renderer_New)(int size);
+
+typedef struct _Enesim_Bench_Renderer_Description
+{
+	const char *name;
+	Enesim_Bench_Renderer_New create;
+} Enesim_Bench_Renderer_Description;
+
+typedef struct _Enesim_Bench_Renderer_Matrix
+{
+	const char *name;
+	double values[9];
+} Enesim_Bench_Renderer_Matrix;
+
+static int sizes[] = { 64, 256, 1024 };
+
+static const char *qualities[] = {
+	"best",
+	"good",
+	"fast",
+};
+
+static Enesim_Bench_Renderer_Matrix matrices[] = {
+	{ "identity", { 1, 0, 0, 0, 1, 0, 0, 0, 1 } },
+	{ "affine", { 0.9, -0.3, 10, 0.3, 0.9, -10, 0, 0, 1 } },
+	{ "projective", { 0.9, -0.3, 10, 0.3, 0.9, -10, 0.0001, 0.0002, 1 } },
+};
+
+static Enesim_Renderer * _background_new(int size EINA_UNUSED)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_background_new();
+	enesim_renderer_background_color_set(r, 0xff336699);
+	return r;
+}
+
+static Enesim_Renderer * _checker_new(int size EINA_UNUSED)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_checker_new();
+	enesim_renderer_checker_even_color_set(r, 0xffcccccc);
+	enesim_renderer_checker_odd_color_set(r, 0xffaaaaaa);
+	enesim_renderer_checker_width_set(r, 10);
+	enesim_renderer_checker_height_set(r, 10);
+	return r;
+}
+
+static Enesim_Renderer * _stripes_new(int size EINA_UNUSED)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_stripes_new();
+	enesim_renderer_stripes_even_color_set(r, 0xffff0000);
+	enesim_renderer_stripes_odd_color_set(r, 0xff0000ff);
+	enesim_renderer_stripes_even_thickness_set(r, 7);
+	enesim_renderer_stripes_odd_thickness_set(r, 5);
+	return r;
+}
+
+static Enesim_Renderer * _perlin_new(int size EINA_UNUSED)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_perlin_new();
+	enesim_renderer_perlin_octaves_set(r, 6);
+	enesim_renderer_perlin_persistence_set(r, 0.3);
+	enesim_renderer_perlin_xfrequency_set(r, 0.03);
+	enesim_renderer_perlin_yfrequency_set(r, 0.03);
+	return r;
+}
+
+static void _gradient_stops_add(Enesim_Renderer *r)
+{
+	Enesim_Renderer_Gradient_Stop stop;
+
+	stop.argb = 0xffff0000;
+	stop.pos = 0;
+	enesim_renderer_gradient_stop_add(r, &stop);
+	stop.argb = 0x8000ff00;
+	stop.pos = 0.5;
+	enesim_renderer_gradient_stop_add(r, &stop);
+	stop.argb = 0xff0000ff;
+	stop.pos = 1;
+	enesim_renderer_gradient_stop_add(r, &stop);
+}
+
+static Enesim_Renderer * _gradient_linear_new(int size)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_gradient_linear_new();
+	enesim_renderer_gradient_linear_position_set(r, 0, 0, size, size);
+	enesim_renderer_gradient_repeat_mode_set(r, ENESIM_REPEAT_MODE_REFLECT);
+	_gradient_stops_add(r);
+	return r;
+}
+
+static Enesim_Renderer * _gradient_radial_new(int size)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_gradient_radial_new();
+	enesim_renderer_gradient_radial_center_set(r, size / 2, size / 2);
+	enesim_renderer_gradient_radial_focus_set(r, size / 3, size / 3);
+	enesim_renderer_gradient_radial_radius_set(r, size / 2);
+	enesim_renderer_gradient_repeat_mode_set(r, ENESIM_REPEAT_MODE_REPEAT);
+	_gradient_stops_add(r);
+	return r;
+}
+
+static void _shape_setup(Enesim_Renderer *r)
+{
+	enesim_renderer_shape_fill_color_set(r, 0xffff0000);
+	enesim_renderer_shape_stroke_color_set(r, 0xff0000ff);
+	enesim_renderer_shape_stroke_weight_set(r, 3);
+	enesim_renderer_shape_draw_mode_set(r,
+			ENESIM_RENDERER_SHAPE_DRAW_MODE_STROKE_FILL);
+}
+
+static Enesim_Renderer * _rectangle_new(int size)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_rectangle_new();
+	enesim_renderer_rectangle_position_set(r, size / 8, size / 8);
+	enesim_renderer_rectangle_size_set(r, size * 3 / 4, size * 3 / 4);
+	enesim_renderer_rectangle_corner_radii_set(r, size / 16, size / 16);
+	enesim_renderer_rectangle_corners_set(r, EINA_TRUE, EINA_TRUE,
+			EINA_TRUE, EINA_TRUE);
+	_shape_setup(r);
+	return r;
+}
+
+static Enesim_Renderer * _circle_new(int size)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_circle_new();
+	enesim_renderer_circle_center_set(r, size / 2, size / 2);
+	enesim_renderer_circle_radius_set(r, size * 3 / 8);
+	_shape_setup(r);
+	return r;
+}
+
+static Enesim_Renderer * _ellipse_new(int size)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_ellipse_new();
+	enesim_renderer_ellipse_center_set(r, size / 2, size / 2);
+	enesim_renderer_ellipse_radii_set(r, size * 3 / 8, size / 4);
+	_shape_setup(r);
+	return r;
+}
+
+static Enesim_Surface * _image_source_new(int size)
+{
+	Enesim_Renderer *r;
+	Enesim_Surface *s;
+
+	r = _gradient_radial_new(size);
+	s = enesim_surface_new(ENESIM_FORMAT_ARGB8888, size, size);
+	enesim_renderer_draw(r, s, ENESIM_ROP_FILL, NULL, 0, 0, NULL);
+	enesim_renderer_unref(r);
+
+	return s;
+}
+
+static Enesim_Renderer * _image_new(int size)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_image_new();
+	/* scale a half sized image to the whole area */
+	enesim_renderer_image_source_surface_set(r, _image_source_new(size / 2));
+	enesim_renderer_image_size_set(r, size, size);
+	return r;
+}
+
+static Enesim_Renderer * _blur_new(int size)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_blur_new();
+	enesim_renderer_blur_source_surface_set(r, _image_source_new(size));
+	enesim_renderer_blur_radius_x_set(r, 4);
+	enesim_renderer_blur_radius_y_set(r, 4);
+	return r;
+}
+
+static Enesim_Renderer * _pattern_new(int size)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_pattern_new();
+	enesim_renderer_pattern_source_renderer_set(r, _circle_new(size / 8));
+	enesim_renderer_pattern_repeat_mode_set(r, ENESIM_REPEAT_MODE_REPEAT);
+	return r;
+}
+
+static Enesim_Renderer * _compound_new(int size)
+{
+	Enesim_Renderer *r;
+	int i;
+
+	r = enesim_renderer_compound_new();
+	for (i = 0; i < 8; i++)
+	{
+		Enesim_Renderer_Compound_Layer *l;
+		Enesim_Renderer *rect;
+
+		rect = enesim_renderer_rectangle_new();
+		enesim_renderer_rectangle_position_set(rect, i * size / 16,
+				i * size / 16);
+		enesim_renderer_rectangle_size_set(rect, size / 2, size / 2);
+		enesim_renderer_shape_fill_color_set(rect, 0x80000000 | (i * 0x1f1f));
+		enesim_renderer_shape_draw_mode_set(rect,
+				ENESIM_RENDERER_SHAPE_DRAW_MODE_FILL);
+
+		l = enesim_renderer_compound_layer_new();
+		enesim_renderer_compound_layer_renderer_set(l, rect);
+		enesim_renderer_compound_layer_rop_set(l, ENESIM_ROP_BLEND);
+		enesim_renderer_compound_layer_add(r, l);
+	}
+	return r;
+}
+
+static Enesim_Renderer * _text_span_new(int size)
+{
+	Enesim_Renderer *r;
+	Enesim_Text_Font *f;
+	Enesim_Text_Engine *e;
+
+	e = enesim_text_engine_default_get();
+	if (!e) return NULL;
+
+	f = enesim_text_font_new_description_from(e, "sans", size / 16 + 8);
+	enesim_text_engine_unref(e);
+	if (!f) return NULL;
+
+	r = enesim_renderer_text_span_new();
+	enesim_renderer_color_set(r, 0xff000000);
+	enesim_renderer_text_span_text_set(r, "The quick brown fox jumps over "
+			"the lazy dog 0123456789");
+	enesim_renderer_text_span_font_set(r, f);
+	enesim_renderer_text_span_position_set(r, 0, size / 2);
+
+	return r;
+}
+
+static Enesim_Bench_Renderer_Description renderers[] = {
+	{ "background", _background_new },
+	{ "checker", _checker_new },
+	{ "stripes", _stripes_new },
+	{ "perlin", _perlin_new },
+	{ "gradient_linear", _gradient_linear_new },
+	{ "gradient_radial", _gradient_radial_new },
+	{ "rectangle", _rectangle_new },
+	{ "circle", _circle_new },
+	{ "ellipse", _ellipse_new },
+	{ "image", _image_new },
+	{ "blur", _blur_new },
+	{ "pattern", _pattern_new },
+	{ "compound", _compound_new },
+	{ "text_span", _text_span_new },
+};
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+void enesim_bench_renderer(Enesim_Bench_Options *options)
+{
+	unsigned int i, j, k, l;
+
+	for (i = 0; i < sizeof(renderers) / sizeof(Enesim_Bench_Renderer_Description); i++)
+	{
+		Enesim_Bench_Renderer_Description *d = &renderers[i];
+
+		if (options->filter && !strstr(d->name, options->filter))
+			continue;
+
+		for (j = 0; j < sizeof(sizes) / sizeof(int); j++)
+		{
+			Enesim_Renderer *r;
+			Enesim_Surface *s;
+
+			r = d->create(sizes[j]);
+			if (!r)
+			{
+				fprintf(stderr, "Renderer '%s' can not be created\n",
+						d->name);
+				break;
+			}
+			s = enesim_surface_new(ENESIM_FORMAT_ARGB8888, sizes[j],
+					sizes[j]);
+			for (k = 0; k < ENESIM_QUALITY_LAST; k++)
+			{
+				for (l = 0; l < sizeof(matrices) / sizeof(Enesim_Bench_Renderer_Matrix); l++)
+				{
+					Enesim_Matrix m;
+					double *v = matrices[l].values;
+					char params[PATH_MAX];
+
+					enesim_matrix_values_set(&m, v[0], v[1], v[2],
+							v[3], v[4], v[5], v[6], v[7],
+							v[8]);
+					enesim_renderer_transformation_set(r, &m);
+					enesim_renderer_quality_set(r, k);
+					snprintf(params, sizeof(params),
+							"size=%d quality=%s matrix=%s",
+							sizes[j], qualities[k],
+							matrices[l].name);
+					enesim_bench_renderer_run(options, "renderer",
+							d->name, params, r, s,
+							ENESIM_ROP_FILL);
+				}
+			}
+			enesim_surface_unref(s);
+			enesim_renderer_unref(r);
+		}
+	}
+}
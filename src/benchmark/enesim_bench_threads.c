@@ -0,0 +1,97 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_bench.h"
+
+/* The same set of scenes drawn with a different number of drawing threads.
+ * The runner does a complete init/shutdown cycle for every thread count, so
+ * everything must be created inside the suite
+ */
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+#define BENCH_THREADS_SIZE 1024
+
+static Enesim_Renderer * _threads_perlin_new(void)
+{
+	Enesim_Renderer *r;
+
+	r = enesim_renderer_perlin_new();
+	enesim_renderer_perlin_octaves_set(r, 6);
+	enesim_renderer_perlin_persistence_set(r, 0.3);
+	enesim_renderer_perlin_xfrequency_set(r, 0.03);
+	enesim_renderer_perlin_yfrequency_set(r, 0.03);
+	return r;
+}
+
+static Enesim_Renderer * _threads_scene_new(void)
+{
+	Enesim_Renderer *r;
+	Enesim_Renderer_Compound_Layer *l;
+	int i;
+
+	r = enesim_renderer_compound_new();
+	/* the background */
+	l = enesim_renderer_compound_layer_new();
+	enesim_renderer_compound_layer_renderer_set(l, _threads_perlin_new());
+	enesim_renderer_compound_layer_rop_set(l, ENESIM_ROP_FILL);
+	enesim_renderer_compound_layer_add(r, l);
+	/* some shapes on top */
+	for (i = 0; i < 16; i++)
+	{
+		Enesim_Renderer *c;
+
+		c = enesim_renderer_circle_new();
+		enesim_renderer_circle_center_set(c, (i % 4) * 256 + 128,
+				(i / 4) * 256 + 128);
+		enesim_renderer_circle_radius_set(c, 100);
+		enesim_renderer_shape_fill_color_set(c, 0x80ff0000);
+		enesim_renderer_shape_stroke_color_set(c, 0xff000000);
+		enesim_renderer_shape_stroke_weight_set(c, 4);
+		enesim_renderer_shape_draw_mode_set(c,
+				ENESIM_RENDERER_SHAPE_DRAW_MODE_STROKE_FILL);
+
+		l = enesim_renderer_compound_layer_new();
+		enesim_renderer_compound_layer_renderer_set(l, c);
+		enesim_renderer_compound_layer_rop_set(l, ENESIM_ROP_BLEND);
+		enesim_renderer_compound_layer_add(r, l);
+	}
+	return r;
+}
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+void enesim_bench_threads(Enesim_Bench_Options *options)
+{
+	Enesim_Renderer *r;
+	Enesim_Surface *s;
+
+	s = enesim_surface_new(ENESIM_FORMAT_ARGB8888, BENCH_THREADS_SIZE,
+			BENCH_THREADS_SIZE);
+
+	r = _threads_perlin_new();
+	enesim_bench_renderer_run(options, "threads", "perlin", NULL, r, s,
+			ENESIM_ROP_FILL);
+	enesim_renderer_unref(r);
+
+	r = _threads_scene_new();
+	enesim_bench_renderer_run(options, "threads", "scene", NULL, r, s,
+			ENESIM_ROP_FILL);
+	enesim_renderer_unref(r);
+
+	enesim_surface_unref(s);
+}
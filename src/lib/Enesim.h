@@ -68,6 +68,7 @@
  * @brief Enesim API
  */
 
+#include <stdio.h>
 #include <inttypes.h>
 
 #include <Eina.h>
@@ -69,6 +69,8 @@ src/lib/enesim_renderer_opengl_private.h \
 src/lib/enesim_renderer_private.h \
 src/lib/enesim_renderer_sw.c \
 src/lib/enesim_renderer_sw_private.h \
+src/lib/enesim_renderer_stats.c \
+src/lib/enesim_renderer_stats_private.h \
 src/lib/enesim_stream_private.h \
 src/lib/enesim_stream.c \
 src/lib/enesim_surface.c \
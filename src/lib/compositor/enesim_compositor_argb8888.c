@@ -203,6 +203,40 @@ static void _argb8888_sp_argb8888_none_argb8888_luminance_blend(uint32_t *d,
 	enesim_color_blend_sp_argb8888_none_argb8888_luminance(d, len, s, m);
 }
 
+/*----------------------------------------------------------------------------*
+ *                               Run funcitons                                *
+ *----------------------------------------------------------------------------*/
+static void _argb8888_run_fill(uint32_t *d, uint32_t len, uint32_t color)
+{
+	enesim_color_fill_sp_none_color_none(d, len, color);
+}
+
+/* the color is only known when drawing, so choose here the best case */
+static void _argb8888_run_blend(uint32_t *d, uint32_t len, uint32_t color)
+{
+	switch (color >> 24)
+	{
+		case 0:
+		break;
+
+		case 0xff:
+		enesim_color_fill_sp_none_color_none(d, len, color);
+		break;
+
+		default:
+		_argb8888_sp_none_color_none_blend(d, len, NULL, color, NULL);
+		break;
+	}
+}
+
+static void _run_register(void)
+{
+	enesim_compositor_run_register(_argb8888_run_fill, ENESIM_ROP_FILL,
+			ENESIM_FORMAT_ARGB8888);
+	enesim_compositor_run_register(_argb8888_run_blend, ENESIM_ROP_BLEND,
+			ENESIM_FORMAT_ARGB8888);
+}
+
 static void _span_register(void)
 {
 	/* color */
@@ -315,6 +349,7 @@ void enesim_compositor_argb8888_init(void)
 {
 	_span_register();
 	_point_register();
+	_run_register();
 }
 
 void enesim_compositor_argb8888_shutdown(void)
@@ -21,12 +21,16 @@
 #include "enesim_pool.h"
 #include "enesim_buffer.h"
 
-#include "enesim_color_private.h"
 #include "enesim_converter_private.h"
 /*============================================================================*
  *                                  Local                                     *
  *============================================================================*/
 /** @cond internal */
+/* the reciprocal of every alpha on 16.16, rounded up so the product
+ * matches the division for every component
+ */
+static uint32_t _unpre[256];
+
 static void _2d_argb8888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t dw, uint32_t dh,
 		Enesim_Buffer_Sw_Data *sdata, uint32_t sw EINA_UNUSED, uint32_t sh EINA_UNUSED)
 {
@@ -42,20 +46,56 @@ static void _2d_argb8888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t
 		uint32_t ddw = dw;
 		while (ddw--)
 		{
+			uint32_t p = *ssrc;
 			uint8_t pa;
 
-			pa = (*ssrc >> 24);
+			pa = (p >> 24);
 			if ((pa > 0) && (pa < 255))
 			{
-				*ddst = (pa << 24)|
-					(((enesim_color_red_get(*ssrc) * 255) / pa) << 16) |
-					(((enesim_color_green_get(*ssrc) * 255) / pa) << 8) |
-					((enesim_color_blue_get(*ssrc) * 255) / pa);
+				uint32_t inv = _unpre[pa];
+
+				*ddst = (p & 0xff000000) |
+					(((((p >> 16) & 0xff) * inv) >> 16) << 16) |
+					(((((p >> 8) & 0xff) * inv) >> 16) << 8) |
+					(((p & 0xff) * inv) >> 16);
 			}
 			else
 			{
-				*ddst = *ssrc;
+				*ddst = p;
+			}
+			ssrc++;
+			ddst++;
+		}
+		dst += dstride;
+		src += sstride;
+	}
+}
+
+static void _2d_argb8888_pre_none_argb8888(Enesim_Buffer_Sw_Data *data, uint32_t dw, uint32_t dh,
+		Enesim_Buffer_Sw_Data *sdata, uint32_t sw EINA_UNUSED, uint32_t sh EINA_UNUSED)
+{
+	uint8_t *src = (uint8_t *)sdata->argb8888.plane0;
+	uint8_t *dst = (uint8_t *)data->argb8888_pre.plane0;
+	size_t dstride = data->argb8888_pre.plane0_stride;
+	size_t sstride = sdata->argb8888.plane0_stride;
+
+	while (dh--)
+	{
+		uint32_t *ddst = (uint32_t *)dst;
+		uint32_t *ssrc = (uint32_t *)src;
+		uint32_t ddw = dw;
+		while (ddw--)
+		{
+			uint32_t p = *ssrc;
+			uint16_t a = (p >> 24) + 1;
+
+			/* multiply the red and blue at once */
+			if (a != 256)
+			{
+				p = (p & 0xff000000) + ((((p >> 8) & 0xff) * a) & 0xff00) +
+						((((p & 0x00ff00ff) * a) >> 8) & 0x00ff00ff);
 			}
+			*ddst = p;
 			ssrc++;
 			ddst++;
 		}
@@ -69,10 +109,20 @@ static void _2d_argb8888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t
  *============================================================================*/
 void enesim_converter_argb8888_init(void)
 {
+	int i;
+
+	_unpre[0] = 0;
+	for (i = 1; i < 256; i++)
+		_unpre[i] = ((255 << 16) + i - 1) / i;
 	enesim_converter_surface_register(
 			ENESIM_CONVERTER_2D(_2d_argb8888_none_argb8888_pre),
 			ENESIM_BUFFER_FORMAT_ARGB8888,
 			ENESIM_ANGLE_NONE,
 			ENESIM_BUFFER_FORMAT_ARGB8888_PRE);
+	enesim_converter_surface_register(
+			ENESIM_CONVERTER_2D(_2d_argb8888_pre_none_argb8888),
+			ENESIM_BUFFER_FORMAT_ARGB8888_PRE,
+			ENESIM_ANGLE_NONE,
+			ENESIM_BUFFER_FORMAT_ARGB8888);
 }
 /** @endcond */
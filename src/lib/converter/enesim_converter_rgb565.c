@@ -27,40 +27,235 @@
  *                                  Local                                     *
  *============================================================================*/
 /** @cond internal */
+static inline uint16_t _rgb565_pack(uint32_t p)
+{
+	return ((p & 0xf80000) >> 8) | ((p & 0xfc00) >> 5) | ((p & 0xf8) >> 3);
+}
+
 static void _2d_rgb565_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t dw, uint32_t dh,
 		Enesim_Buffer_Sw_Data *sdata, uint32_t sw EINA_UNUSED, uint32_t sh EINA_UNUSED)
 {
-	uint16_t *dst = data->rgb565.plane0;
-	uint32_t *src = sdata->argb8888_pre.plane0;
+	uint8_t *dst = (uint8_t *)data->rgb565.plane0;
+	uint8_t *src = (uint8_t *)sdata->argb8888_pre.plane0;
+	size_t dstride = data->rgb565.plane0_stride;
+	size_t sstride = sdata->argb8888_pre.plane0_stride;
+
+	while (dh--)
+	{
+		uint16_t *ddst = (uint16_t *)dst;
+		uint32_t *ssrc = (uint32_t *)src;
+		uint32_t ddw = dw;
+
+		/* write two pixels at once on an aligned destination */
+		if (((uintptr_t)ddst & 3) && ddw)
+		{
+			*ddst++ = _rgb565_pack(*ssrc++);
+			ddw--;
+		}
+		while (ddw >= 2)
+		{
+			uint32_t w;
+
+#ifdef WORDS_BIGENDIAN
+			w = (_rgb565_pack(ssrc[0]) << 16) | _rgb565_pack(ssrc[1]);
+#else
+			w = _rgb565_pack(ssrc[0]) | (_rgb565_pack(ssrc[1]) << 16);
+#endif
+			memcpy(ddst, &w, sizeof(w));
+			ddst += 2;
+			ssrc += 2;
+			ddw -= 2;
+		}
+		if (ddw)
+			*ddst = _rgb565_pack(*ssrc);
+		dst += dstride;
+		src += sstride;
+	}
+}
+
+/* the 8x8 Bayer matrix */
+static const uint8_t _bayer[64] = {
+	 0, 32,  8, 40,  2, 34, 10, 42,
+	48, 16, 56, 24, 50, 18, 58, 26,
+	12, 44,  4, 36, 14, 46,  6, 38,
+	60, 28, 52, 20, 62, 30, 54, 22,
+	 3, 35, 11, 43,  1, 33,  9, 41,
+	51, 19, 59, 27, 49, 17, 57, 25,
+	15, 47,  7, 39, 13, 45,  5, 37,
+	63, 31, 55, 23, 61, 29, 53, 21,
+};
+
+/* the thresholds of the red and blue at once and the green ones */
+static uint32_t _ordered_rb[64];
+static uint32_t _ordered_g[64];
+
+static void _2d_rgb565_ordered_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t dw, uint32_t dh,
+		Enesim_Buffer_Sw_Data *sdata, int x, int y)
+{
+	uint8_t *dst = (uint8_t *)data->rgb565.plane0;
+	uint8_t *src = (uint8_t *)sdata->argb8888_pre.plane0;
 	size_t dstride = data->rgb565.plane0_stride;
-	size_t sstride = data->argb8888_pre.plane0_stride / 4;
+	size_t sstride = sdata->argb8888_pre.plane0_stride;
 
 	while (dh--)
 	{
-		uint16_t *ddst = dst;
-		uint32_t *ssrc = src;
+		uint16_t *ddst = (uint16_t *)dst;
+		uint32_t *ssrc = (uint32_t *)src;
+		const uint32_t *trb = &_ordered_rb[(y & 7) * 8];
+		const uint32_t *tg = &_ordered_g[(y & 7) * 8];
 		uint32_t ddw = dw;
+		int xx = x;
+
 		while (ddw--)
 		{
-			*dst = ((*src & 0xf80000) >> 8) | ((*src & 0xfc00) >> 5)
-					| ((*src & 0xf8) >> 3);
+			uint32_t p = *ssrc;
+			uint32_t rb, g, m;
+
+			/* scale the components to the range of the expanded
+			 * ones to not brighten the result
+			 */
+			rb = p & 0x00ff00ff;
+			rb -= (rb >> 5) & 0x00070007;
+			g = p & 0x0000ff00;
+			g -= (g >> 6) & 0x00000300;
+			/* add the threshold to the red and blue and saturate
+			 * the ones that overflow
+			 */
+			rb += trb[xx & 7];
+			m = rb & 0x01000100;
+			rb = (rb | (m - (m >> 8))) & 0x00ff00ff;
+			g += tg[xx & 7];
+			if (g > 0xff00) g = 0xff00;
+			*ddst = ((rb & 0xf80000) >> 8) | ((g & 0xfc00) >> 5) |
+					((rb & 0xf8) >> 3);
 			ssrc++;
 			ddst++;
+			xx++;
+		}
+		dst += dstride;
+		src += sstride;
+		y++;
+	}
+}
+
+#define RGB565_DIFFUSE(c, v, bits)						\
+	{									\
+		int q, e;							\
+									\
+		if (v < 0) v = 0;						\
+		else if (v > 255) v = 255;					\
+		q = v >> (8 - bits);						\
+		e = v - ((q << (8 - bits)) | (q >> (2 * bits - 8)));		\
+		cur[(i + dir) * 3 + c] += (e * 7) / 16;				\
+		nxt[(i - dir) * 3 + c] += (e * 3) / 16;				\
+		nxt[i * 3 + c] += (e * 5) / 16;					\
+		nxt[(i + dir) * 3 + c] += e / 16;				\
+		v = q;								\
+	}
+
+/* Floyd-Steinberg error diffusion going through the rows on alternate
+ * directions to avoid the directional artifacts
+ */
+static void _2d_rgb565_error_diffusion_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t dw, uint32_t dh,
+		Enesim_Buffer_Sw_Data *sdata, int x, int y)
+{
+	uint8_t *dst = (uint8_t *)data->rgb565.plane0;
+	uint8_t *src = (uint8_t *)sdata->argb8888_pre.plane0;
+	size_t dstride = data->rgb565.plane0_stride;
+	size_t sstride = sdata->argb8888_pre.plane0_stride;
+	size_t len;
+	int16_t *errors;
+	int16_t *cur;
+	int16_t *nxt;
+
+	/* the errors of the current and next rows with a pixel on each side */
+	len = (dw + 2) * 3;
+	errors = calloc(len * 2, sizeof(int16_t));
+	/* without the error rows use the ordered dither */
+	if (!errors)
+	{
+		_2d_rgb565_ordered_argb8888_pre(data, dw, dh, sdata, x, y);
+		return;
+	}
+	cur = errors;
+	nxt = errors + len;
+
+	while (dh--)
+	{
+		uint16_t *ddst = (uint16_t *)dst;
+		uint32_t *ssrc = (uint32_t *)src;
+		int16_t *tmp;
+		int dir;
+		int i, end;
+
+		if (y & 1)
+		{
+			dir = -1;
+			i = dw;
+			end = 0;
+		}
+		else
+		{
+			dir = 1;
+			i = 1;
+			end = dw + 1;
 		}
+		for (; i != end; i += dir)
+		{
+			uint32_t p = ssrc[i - 1];
+			int r, g, b;
+
+			r = ((p >> 16) & 0xff) + cur[i * 3];
+			g = ((p >> 8) & 0xff) + cur[i * 3 + 1];
+			b = (p & 0xff) + cur[i * 3 + 2];
+			RGB565_DIFFUSE(0, r, 5);
+			RGB565_DIFFUSE(1, g, 6);
+			RGB565_DIFFUSE(2, b, 5);
+			ddst[i - 1] = (r << 11) | (g << 5) | b;
+		}
+		/* the next row is the current one now */
+		tmp = cur;
+		cur = nxt;
+		nxt = tmp;
+		memset(nxt, 0, len * sizeof(int16_t));
+
 		dst += dstride;
 		src += sstride;
+		y++;
 	}
+	free(errors);
 }
+#undef RGB565_DIFFUSE
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
 void enesim_converter_rgb565_init(void)
 {
+	int i;
+
+	/* the thresholds are the matrix scaled to the lost bits, in the
+	 * position of every component
+	 */
+	for (i = 0; i < 64; i++)
+	{
+		_ordered_rb[i] = (_bayer[i] >> 3) * 0x00010001;
+		_ordered_g[i] = (_bayer[i] >> 4) << 8;
+	}
 	/* TODO check if the cpu is the host */
 	enesim_converter_surface_register(
 			ENESIM_CONVERTER_2D(_2d_rgb565_none_argb8888_pre),
 			ENESIM_BUFFER_FORMAT_RGB565,
 			ENESIM_ANGLE_NONE,
 			ENESIM_BUFFER_FORMAT_ARGB8888_PRE);
+	enesim_converter_surface_dither_register(
+			ENESIM_CONVERTER_2D_DITHER(_2d_rgb565_ordered_argb8888_pre),
+			ENESIM_BUFFER_FORMAT_RGB565,
+			ENESIM_BUFFER_DITHER_ORDERED,
+			ENESIM_BUFFER_FORMAT_ARGB8888_PRE);
+	enesim_converter_surface_dither_register(
+			ENESIM_CONVERTER_2D_DITHER(_2d_rgb565_error_diffusion_argb8888_pre),
+			ENESIM_BUFFER_FORMAT_RGB565,
+			ENESIM_BUFFER_DITHER_ERROR_DIFFUSION,
+			ENESIM_BUFFER_FORMAT_ARGB8888_PRE);
 }
 /** @endcond */
@@ -26,6 +26,16 @@
  *                                  Local                                     *
  *============================================================================*/
 /** @cond internal */
+/* every pixel as the three bytes on memory order on the low bits of a word */
+static inline uint32_t _rgb888_pack(uint32_t p)
+{
+#ifdef WORDS_BIGENDIAN
+	return p & 0xffffff;
+#else
+	return ((p >> 16) & 0xff) | (p & 0xff00) | ((p & 0xff) << 16);
+#endif
+}
+
 static void _2d_rgb888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t dw, uint32_t dh,
 		Enesim_Buffer_Sw_Data *sdata, uint32_t sw EINA_UNUSED, uint32_t sh EINA_UNUSED)
 {
@@ -39,6 +49,33 @@ static void _2d_rgb888_none_argb8888_pre(Enesim_Buffer_Sw_Data *data, uint32_t d
 		uint8_t *ddst = dst;
 		uint32_t *ssrc = (uint32_t *)src;
 		uint32_t ddw = dw;
+
+		/* pack four pixels on three words on an aligned destination */
+		if (!((uintptr_t)ddst & 3))
+		{
+			while (ddw >= 4)
+			{
+				uint32_t wdst[3];
+				uint32_t p0 = _rgb888_pack(ssrc[0]);
+				uint32_t p1 = _rgb888_pack(ssrc[1]);
+				uint32_t p2 = _rgb888_pack(ssrc[2]);
+				uint32_t p3 = _rgb888_pack(ssrc[3]);
+
+#ifdef WORDS_BIGENDIAN
+				wdst[0] = (p0 << 8) | (p1 >> 16);
+				wdst[1] = (p1 << 16) | (p2 >> 8);
+				wdst[2] = (p2 << 24) | p3;
+#else
+				wdst[0] = p0 | (p1 << 24);
+				wdst[1] = (p1 >> 8) | (p2 << 16);
+				wdst[2] = (p2 >> 16) | (p3 << 8);
+#endif
+				memcpy(ddst, wdst, sizeof(wdst));
+				ddst += 12;
+				ssrc += 4;
+				ddw -= 4;
+			}
+		}
 		while (ddw--)
 		{
 			*ddst++ = (*ssrc >> 16) & 0xff;
@@ -17,6 +17,10 @@
  */
 #include "enesim_private.h"
 
+#if !defined(_WIN32) && !defined(HAVE_POSIX_MEMALIGN)
+#include <malloc.h>
+#endif
+
 #include "enesim_main.h"
 #include "enesim_format.h"
 #include "enesim_pool.h"
@@ -59,6 +63,11 @@ static void _buffer_data_free(void *data, void *user_data EINA_UNUSED)
 	free(data);
 }
 
+/* rows that are a multiple of the page size apart map to the same L1 sets,
+ * pad them with an extra cache line to avoid the aliasing
+ */
+#define ENESIM_BUFFER_SW_ALIAS_SIZE 4096
+
 static Eina_Bool _buffer_format_has_alpha(Enesim_Buffer_Format fmt)
 {
 	switch (fmt)
@@ -180,6 +189,96 @@ Eina_Bool enesim_buffer_sw_data_alloc(Enesim_Buffer_Sw_Data *data,
 	return ret;
 }
 
+void * enesim_buffer_sw_aligned_alloc(size_t size)
+{
+	void *ret = NULL;
+
+#ifdef _WIN32
+	ret = _aligned_malloc(size, ENESIM_BUFFER_SW_ALIGNMENT);
+#else
+# ifdef HAVE_POSIX_MEMALIGN
+	if (posix_memalign(&ret, ENESIM_BUFFER_SW_ALIGNMENT, size))
+		ret = NULL;
+# else
+	ret = memalign(ENESIM_BUFFER_SW_ALIGNMENT, size);
+# endif
+#endif
+	return ret;
+}
+
+void enesim_buffer_sw_aligned_free(void *data, void *user_data EINA_UNUSED)
+{
+#ifdef _WIN32
+	_aligned_free(data);
+#else
+	free(data);
+#endif
+}
+
+size_t enesim_buffer_sw_aligned_stride_get(Enesim_Buffer_Format fmt, uint32_t w)
+{
+	size_t stride;
+
+	stride = enesim_buffer_format_size_get(fmt, w, 1);
+	stride = (stride + ENESIM_BUFFER_SW_ALIGNMENT - 1) &
+			~(ENESIM_BUFFER_SW_ALIGNMENT - 1);
+	if (!(stride & (ENESIM_BUFFER_SW_ALIAS_SIZE - 1)))
+		stride += ENESIM_BUFFER_SW_ALIGNMENT;
+	return stride;
+}
+
+/* Same as enesim_buffer_sw_data_alloc() but every row starts on a cache line
+ * so the kernels can rely on the alignment. The memory must be released
+ * with enesim_buffer_sw_aligned_free()
+ */
+Eina_Bool enesim_buffer_sw_data_aligned_alloc(Enesim_Buffer_Sw_Data *data,
+		Enesim_Buffer_Format fmt, uint32_t w, uint32_t h)
+{
+	Eina_Bool ret;
+	switch (fmt)
+	{
+		/* packed case */
+		case ENESIM_BUFFER_FORMAT_ARGB8888:
+		case ENESIM_BUFFER_FORMAT_ARGB8888_PRE:
+		case ENESIM_BUFFER_FORMAT_CMYK:
+		case ENESIM_BUFFER_FORMAT_CMYK_ADOBE:
+		case ENESIM_BUFFER_FORMAT_BGR888:
+		case ENESIM_BUFFER_FORMAT_RGB888:
+		case ENESIM_BUFFER_FORMAT_RGB565:
+		case ENESIM_BUFFER_FORMAT_A8:
+		case ENESIM_BUFFER_FORMAT_GRAY:
+		{
+			size_t bytes;
+			size_t stride;
+			void *alloc_data;
+
+			stride = enesim_buffer_sw_aligned_stride_get(fmt, w);
+			bytes = stride * h;
+			alloc_data = enesim_buffer_sw_aligned_alloc(bytes);
+			if (!alloc_data)
+			{
+				ERR("Impossible to allocate %zu bytes", bytes);
+				ret = EINA_FALSE;
+				break;
+			}
+			memset(alloc_data, 0, bytes);
+			ret = enesim_buffer_sw_data_set(data, fmt, alloc_data, stride);
+			if (!ret)
+			{
+				enesim_buffer_sw_aligned_free(alloc_data, NULL);
+			}
+		}
+		break;
+
+		/* planar case */
+		default:
+		ERR("Format not supported");
+		ret = EINA_FALSE;
+		break;
+	}
+	return ret;
+}
+
 /* FIXME change this to pass void[] content and int[] strides
  * TODO add a function to get the number of planes
  */
@@ -298,40 +397,46 @@ Eina_Bool enesim_buffer_sw_data_at(Enesim_Buffer_Sw_Data *data,
 		/* 32 bpp */
 		case ENESIM_BUFFER_FORMAT_ARGB8888:
 		at->argb8888.plane0 = (uint32_t *)((uint8_t *)data->argb8888.plane0 +
-				(y * data->argb8888.plane0_stride) + x);
+				(y * data->argb8888.plane0_stride) + (x * 4));
 		at->argb8888.plane0_stride = data->argb8888.plane0_stride;
 		break;
 
 		case ENESIM_BUFFER_FORMAT_ARGB8888_PRE:
 		at->argb8888_pre.plane0 = (uint32_t *)((uint8_t *)data->argb8888_pre.plane0 +
-				(y * data->argb8888_pre.plane0_stride) + x);
+				(y * data->argb8888_pre.plane0_stride) + (x * 4));
 		at->argb8888_pre.plane0_stride = data->argb8888_pre.plane0_stride;
 		break;
 
+		case ENESIM_BUFFER_FORMAT_XRGB8888:
+		at->xrgb8888.plane0 = (uint32_t *)((uint8_t *)data->xrgb8888.plane0 +
+				(y * data->xrgb8888.plane0_stride) + (x * 4));
+		at->xrgb8888.plane0_stride = data->xrgb8888.plane0_stride;
+		break;
+
 		/* 24 bpp */
 		case ENESIM_BUFFER_FORMAT_BGR888:
 		at->bgr888.plane0 = data->bgr888.plane0 +
-				(y * data->bgr888.plane0_stride) + x;
+				(y * data->bgr888.plane0_stride) + (x * 3);
 		at->bgr888.plane0_stride = data->bgr888.plane0_stride;
 		break;
 
 		case ENESIM_BUFFER_FORMAT_RGB888:
 		at->rgb888.plane0 = data->rgb888.plane0 +
-				(y * data->rgb888.plane0_stride) + x;
+				(y * data->rgb888.plane0_stride) + (x * 3);
 		at->rgb888.plane0_stride = data->rgb888.plane0_stride;
 		break;
 
 		case ENESIM_BUFFER_FORMAT_CMYK:
 		case ENESIM_BUFFER_FORMAT_CMYK_ADOBE:
 		at->cmyk.plane0 = data->cmyk.plane0 +
-				(y * data->cmyk.plane0_stride) + x;
+				(y * data->cmyk.plane0_stride) + (x * 4);
 		at->cmyk.plane0_stride = data->cmyk.plane0_stride;
 		break;
 
 		/* 16 bpp */
 		case ENESIM_BUFFER_FORMAT_RGB565:
 		at->rgb565.plane0 = (uint16_t *)((uint8_t *)data->rgb565.plane0 +
-				(y * data->rgb565.plane0_stride) + x);
+				(y * data->rgb565.plane0_stride) + (x * 2));
 		at->rgb565.plane0_stride = data->rgb565.plane0_stride;
 		break;
 
@@ -1012,43 +1117,8 @@ EAPI Enesim_Alpha_Hint enesim_buffer_alpha_hint_get(Enesim_Buffer *thiz)
  */
 EAPI Eina_Bool enesim_buffer_convert(Enesim_Buffer *thiz, Enesim_Buffer *dst)
 {
-	Enesim_Converter_2D converter;
-	Enesim_Buffer_Format dfmt;
-	Enesim_Buffer_Format sfmt;
-	Enesim_Buffer_Sw_Data ddata;
-	Enesim_Buffer_Sw_Data sdata;
-	int w, h, dstw, dsth;
-
-	sfmt = enesim_buffer_format_get(thiz);
-	dfmt = enesim_buffer_format_get(dst);
-	if (sfmt == dfmt)
-		return EINA_FALSE;
-
-	enesim_buffer_size_get(thiz, &w, &h);
-	enesim_buffer_size_get(dst, &dstw, &dsth);
-	if (dstw != w || dsth != h)
-		return EINA_FALSE;
-
-	converter = enesim_converter_surface_get(dfmt, ENESIM_ANGLE_NONE, sfmt);
-	if (!converter)
-		return EINA_FALSE;
-
-	if (!enesim_buffer_map(thiz, &sdata))
-		return EINA_FALSE;
-
-	if (!enesim_buffer_map(dst, &ddata))
-	{
-		enesim_buffer_unmap(thiz, &sdata, EINA_FALSE);
-		return EINA_FALSE;
-	}
-
-	/* FIXME check the stride too */
-	/* TODO check the clip and x, y */
-	converter(&ddata, w, h, &sdata, w, h);
-	enesim_buffer_unmap(thiz, &sdata, EINA_FALSE);
-	enesim_buffer_unmap(dst, &ddata, EINA_TRUE);
-
-	return EINA_TRUE;
+	return enesim_buffer_convert_dithered(thiz, dst, NULL,
+			ENESIM_BUFFER_DITHER_NONE);
 }
 
 /**
@@ -1060,8 +1130,30 @@ EAPI Eina_Bool enesim_buffer_convert(Enesim_Buffer *thiz, Enesim_Buffer *dst)
  * @return EINA_TRUE if the conversion was correct, EINA_FALSE otherwise
  */
 EAPI Eina_Bool enesim_buffer_convert_list(Enesim_Buffer *thiz, Enesim_Buffer *dst, Eina_List *clips)
+{
+	return enesim_buffer_convert_dithered(thiz, dst, clips,
+			ENESIM_BUFFER_DITHER_NONE);
+}
+
+/**
+ * Converts a buffer into another buffer dithering the components
+ * @param[in] thiz The buffer to convert
+ * @param[in] dst The destination buffer
+ * @param[in] clips A list of clipping areas on the destination surface to limit the conversion. @ender_nullable
+ * @param[in] dither The dithering mode to use
+ * @return EINA_TRUE if the conversion was correct, EINA_FALSE otherwise
+ *
+ * The dithering only applies to destination formats with less bits per
+ * component than the source, like @ref ENESIM_BUFFER_FORMAT_RGB565. For the
+ * rest of the formats the conversion is done as in enesim_buffer_convert().
+ * The ordered dithering is anchored to the buffer origin, so the result does
+ * not depend on the clipping areas.
+ */
+EAPI Eina_Bool enesim_buffer_convert_dithered(Enesim_Buffer *thiz,
+		Enesim_Buffer *dst, Eina_List *clips, Enesim_Buffer_Dither dither)
 {
 	Enesim_Converter_2D converter;
+	Enesim_Converter_2D_Dither dconverter = NULL;
 	Enesim_Buffer_Format dfmt;
 	Enesim_Buffer_Format sfmt;
 	Enesim_Buffer_Sw_Data ddata;
@@ -1083,22 +1175,52 @@ EAPI Eina_Bool enesim_buffer_convert_list(Enesim_Buffer *thiz, Enesim_Buffer *ds
 	converter = enesim_converter_surface_get(dfmt, ENESIM_ANGLE_NONE, sfmt);
 	if (!converter)
 		return EINA_FALSE;
+	if (dither != ENESIM_BUFFER_DITHER_NONE)
+		dconverter = enesim_converter_surface_dither_get(dfmt, dither, sfmt);
+
+	if (!enesim_buffer_map(thiz, &sdata))
+		return EINA_FALSE;
 
-	enesim_buffer_sw_data_get(dst, &ddata);
-	enesim_buffer_sw_data_get(thiz, &sdata);
+	if (!enesim_buffer_map(dst, &ddata))
+	{
+		enesim_buffer_unmap(thiz, &sdata, EINA_FALSE);
+		return EINA_FALSE;
+	}
+
+	if (!clips)
+	{
+		if (dconverter)
+			enesim_converter_surface_dither_convert(dconverter,
+					dither, &ddata, dfmt, &sdata, sfmt,
+					0, 0, w, h);
+		else
+			enesim_converter_surface_convert(converter, &ddata,
+					dfmt, &sdata, sfmt, w, h);
+	}
 
 	EINA_LIST_FOREACH(clips, l, area)
 	{
 		Enesim_Buffer_Sw_Data dat;
 		Enesim_Buffer_Sw_Data sat;
-
-		/* FIXME check the stride too */
-		/* TODO check the clip and x, y */
-
-		enesim_buffer_sw_data_at(&ddata, dfmt, area->x, area->y, &dat);
-		enesim_buffer_sw_data_at(&sdata, sfmt, area->x, area->y, &sat);
-		converter(&dat, area->w, area->h, &sat, area->w, area->h);
+		Eina_Rectangle clip;
+
+		eina_rectangle_coords_from(&clip, 0, 0, w, h);
+		if (!eina_rectangle_intersection(&clip, area))
+			continue;
+		if (!enesim_buffer_sw_data_at(&ddata, dfmt, clip.x, clip.y, &dat))
+			continue;
+		if (!enesim_buffer_sw_data_at(&sdata, sfmt, clip.x, clip.y, &sat))
+			continue;
+		if (dconverter)
+			enesim_converter_surface_dither_convert(dconverter,
+					dither, &dat, dfmt, &sat, sfmt,
+					clip.x, clip.y, clip.w, clip.h);
+		else
+			enesim_converter_surface_convert(converter, &dat,
+					dfmt, &sat, sfmt, clip.w, clip.h);
 	}
+	enesim_buffer_unmap(thiz, &sdata, EINA_FALSE);
+	enesim_buffer_unmap(dst, &ddata, EINA_TRUE);
 
 	return EINA_TRUE;
 }
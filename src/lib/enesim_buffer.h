@@ -67,6 +67,20 @@ typedef enum _Enesim_Buffer_Format
 /**< Total number of buffer formats */
 #define ENESIM_BUFFER_FORMAT_LAST (ENESIM_BUFFER_FORMAT_CMYK_ADOBE + 1)
 
+/**
+ * Enumeration of the different dithering modes used when converting into
+ * a format with less bits per component
+ */
+typedef enum _Enesim_Buffer_Dither
+{
+	ENESIM_BUFFER_DITHER_NONE, /**< The components are truncated */
+	ENESIM_BUFFER_DITHER_ORDERED, /**< Ordered dithering with a 8x8 Bayer matrix */
+	ENESIM_BUFFER_DITHER_ERROR_DIFFUSION, /**< Serpentine Floyd-Steinberg error diffusion */
+} Enesim_Buffer_Dither;
+
+/**< Total number of dithering modes */
+#define ENESIM_BUFFER_DITHER_LAST (ENESIM_BUFFER_DITHER_ERROR_DIFFUSION + 1)
+
 EAPI Eina_Bool enesim_buffer_format_rgb_components_from(
 		Enesim_Buffer_Format *fmt, int depth,
 		uint8_t aoffset, uint8_t alen,
@@ -229,6 +243,8 @@ EAPI Enesim_Alpha_Hint enesim_buffer_alpha_hint_get(Enesim_Buffer *thiz);
 
 EAPI Eina_Bool enesim_buffer_convert(Enesim_Buffer *thiz, Enesim_Buffer *dst);
 EAPI Eina_Bool enesim_buffer_convert_list(Enesim_Buffer *thiz, Enesim_Buffer *dst, Eina_List *clips);
+EAPI Eina_Bool enesim_buffer_convert_dithered(Enesim_Buffer *thiz,
+		Enesim_Buffer *dst, Eina_List *clips, Enesim_Buffer_Dither dither);
 
 /** @} */ //End of Enesim_Buffer
 
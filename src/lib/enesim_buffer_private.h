@@ -53,9 +53,17 @@ struct _Enesim_Buffer
 	void *user; /* user provided data */
 };
 
+/* the alignment of the rows of the buffers allocated by the sw pool */
+#define ENESIM_BUFFER_SW_ALIGNMENT 64
+
 void * enesim_buffer_backend_data_get(Enesim_Buffer *b);
 Eina_Bool enesim_buffer_sw_data_alloc(Enesim_Buffer_Sw_Data *data,
 		Enesim_Buffer_Format fmt, uint32_t w, uint32_t h);
+Eina_Bool enesim_buffer_sw_data_aligned_alloc(Enesim_Buffer_Sw_Data *data,
+		Enesim_Buffer_Format fmt, uint32_t w, uint32_t h);
+void * enesim_buffer_sw_aligned_alloc(size_t size);
+void enesim_buffer_sw_aligned_free(void *data, void *user_data);
+size_t enesim_buffer_sw_aligned_stride_get(Enesim_Buffer_Format fmt, uint32_t w);
 Eina_Bool enesim_buffer_sw_data_set(Enesim_Buffer_Sw_Data *data,
 		Enesim_Buffer_Format fmt, void *content0, int stride0);
 Eina_Bool enesim_buffer_sw_data_free(Enesim_Buffer_Sw_Data *data,
@@ -42,6 +42,8 @@ typedef struct _Enesim_Compositor
 	Enesim_Compositor_Span sp_pixel[ENESIM_ROP_LAST][ENESIM_FORMAT_LAST][ENESIM_FORMAT_LAST];
 	Enesim_Compositor_Span sp_pixel_color[ENESIM_ROP_LAST][ENESIM_FORMAT_LAST][ENESIM_FORMAT_LAST];
 	Enesim_Compositor_Span sp_pixel_mask[ENESIM_ROP_LAST][ENESIM_FORMAT_LAST][ENESIM_FORMAT_LAST][ENESIM_FORMAT_LAST][ENESIM_CHANNEL_LAST];
+	/* Runs of a single color */
+	Enesim_Compositor_Run run[ENESIM_ROP_LAST][ENESIM_FORMAT_LAST];
 	/* TODO remove this */
 	/* Points */
 	Enesim_Compositor_Point pt_color[ENESIM_ROP_LAST][ENESIM_FORMAT_LAST];
@@ -217,13 +219,19 @@ void enesim_compositor_span_pixel_color_register(Enesim_Compositor_Span sp,
 	_comps.sp_pixel_color[rop][dfmt][sfmt] = sp;
 }
 
+void enesim_compositor_run_register(Enesim_Compositor_Run run,
+		Enesim_Rop rop, Enesim_Format dfmt)
+{
+	_comps.run[rop][dfmt] = run;
+}
+
 Enesim_Compositor_Span enesim_compositor_span_get(Enesim_Rop rop,
 		Enesim_Format *dfmt, Enesim_Format sfmt, Enesim_Color color,
 		Enesim_Format mfmt, Enesim_Channel mchan)
 {
 	if (!dfmt)
 		return NULL;
-	if (*dfmt <= ENESIM_FORMAT_NONE && *dfmt > ENESIM_FORMAT_LAST)
+	if (*dfmt <= ENESIM_FORMAT_NONE || *dfmt >= ENESIM_FORMAT_LAST)
 		return NULL;
 
 	if (!sfmt && !mfmt)
@@ -246,6 +254,23 @@ Enesim_Compositor_Span enesim_compositor_span_get(Enesim_Rop rop,
 	return NULL;
 }
 
+/*
+ * Returns a function that will draw a run of pixels of the same color using
+ * the raster operation rop for a surface format dfmt. Unlike the color span
+ * functions, the color is not known until the run is drawn
+ */
+Enesim_Compositor_Run enesim_compositor_run_get(Enesim_Rop rop,
+		Enesim_Format *dfmt)
+{
+	if (!dfmt)
+		return NULL;
+	if (*dfmt <= ENESIM_FORMAT_NONE || *dfmt >= ENESIM_FORMAT_LAST)
+		return NULL;
+	if (rop >= ENESIM_ROP_LAST)
+		return NULL;
+	return _comps.run[rop][*dfmt];
+}
+
 /* TODO remove this */
 Enesim_Compositor_Point enesim_compositor_point_get(Enesim_Rop rop,
 		Enesim_Format *dfmt, Enesim_Format sfmt, Enesim_Color color,
@@ -253,7 +278,7 @@ Enesim_Compositor_Point enesim_compositor_point_get(Enesim_Rop rop,
 {
 	if (!dfmt)
 		return NULL;
-	if (*dfmt <= ENESIM_FORMAT_NONE && *dfmt > ENESIM_FORMAT_LAST)
+	if (*dfmt <= ENESIM_FORMAT_NONE || *dfmt >= ENESIM_FORMAT_LAST)
 		return NULL;
 
 	if (!sfmt && !mfmt)
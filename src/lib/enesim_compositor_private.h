@@ -47,6 +47,17 @@ typedef void (*Enesim_Compositor_Span)(uint32_t *d, uint32_t len, uint32_t *s,
 Enesim_Compositor_Span enesim_compositor_span_get(Enesim_Rop rop,
 		Enesim_Format *dfmt, Enesim_Format sfmt, Enesim_Color color,
 		Enesim_Format mfmt, Enesim_Channel mchan);
+/**
+ * Function to draw a run of pixels of the same color
+ * @param d Destination surface data
+ * @param len The length of the run
+ * @param color The color of every pixel of the run
+ */
+typedef void (*Enesim_Compositor_Run)(uint32_t *d, uint32_t len,
+		Enesim_Color color);
+
+Enesim_Compositor_Run enesim_compositor_run_get(Enesim_Rop rop,
+		Enesim_Format *dfmt);
 
 /* TODO remove this */
 Enesim_Compositor_Point enesim_compositor_point_get(Enesim_Rop rop,
@@ -84,4 +95,7 @@ void enesim_compositor_span_pixel_mask_register(Enesim_Compositor_Span sp,
 void enesim_compositor_span_pixel_color_register(Enesim_Compositor_Span sp,
 		Enesim_Rop rop, Enesim_Format dfmt, Enesim_Format sfmt);
 
+void enesim_compositor_run_register(Enesim_Compositor_Run run,
+		Enesim_Rop rop, Enesim_Format dfmt);
+
 #endif /* ENESIM_COMPOSITOR_H_*/
@@ -18,13 +18,22 @@
 #include "enesim_private.h"
 
 #include "enesim_main.h"
+#include "enesim_log.h"
+#include "enesim_color.h"
+#include "enesim_rectangle.h"
+#include "enesim_matrix.h"
 #include "enesim_format.h"
 #include "enesim_pool.h"
 #include "enesim_buffer.h"
 #include "enesim_surface.h"
+#include "enesim_renderer.h"
+#include "enesim_object_descriptor.h"
+#include "enesim_object_class.h"
+#include "enesim_object_instance.h"
 
 #include "enesim_buffer_private.h"
 #include "enesim_converter_private.h"
+#include "enesim_renderer_private.h"
 
 /*
  * TODO
@@ -40,12 +49,149 @@
 /** @cond internal */
 typedef Enesim_Converter_2D Enesim_Converter_2D_Lut[ENESIM_BUFFER_FORMAT_LAST][ENESIM_ANGLE_LAST][ENESIM_BUFFER_FORMAT_LAST];
 
+typedef Enesim_Converter_2D_Dither Enesim_Converter_2D_Dither_Lut[ENESIM_BUFFER_FORMAT_LAST][ENESIM_BUFFER_DITHER_LAST][ENESIM_BUFFER_FORMAT_LAST];
+
 Enesim_Converter_2D_Lut _converters_2d;
+Enesim_Converter_2D_Dither_Lut _converters_2d_dither;
+
+typedef struct _Enesim_Converter_Operation
+{
+	/* only one of them is set */
+	Enesim_Converter_2D cnv;
+	Enesim_Converter_2D_Dither dcnv;
+	Enesim_Buffer_Sw_Data *ddata;
+	Enesim_Buffer_Format dfmt;
+	Enesim_Buffer_Sw_Data *sdata;
+	Enesim_Buffer_Format sfmt;
+	int x;
+	int y;
+	uint32_t w;
+	uint32_t h;
+} Enesim_Converter_Operation;
+
+#ifdef BUILD_MULTI_CORE
+/* below this number of pixels the conversion is done on the calling thread */
+#define ENESIM_CONVERTER_THREADED_PIXELS (256 * 256)
+
+typedef struct _Enesim_Converter_Thread
+{
+	Enesim_Thread tid;
+	unsigned int idx;
+	Eina_Bool done;
+} Enesim_Converter_Thread;
+
+static Enesim_Converter_Thread *_threads = NULL;
+static unsigned int _num_threads = 0;
+static Enesim_Converter_Operation _op;
+static Enesim_Barrier _start;
+static Enesim_Barrier _end;
+/* only one conversion can use the threads at a time */
+static Eina_Lock _lock;
+
+/* every thread converts a band of consecutive rows */
+static void _converter_band(Enesim_Converter_Operation *op, unsigned int idx)
+{
+	Enesim_Buffer_Sw_Data dat;
+	Enesim_Buffer_Sw_Data sat;
+	uint32_t y0, y1;
+
+	y0 = ((uint64_t)op->h * idx) / _num_threads;
+	y1 = ((uint64_t)op->h * (idx + 1)) / _num_threads;
+	if (y0 == y1)
+		return;
+	enesim_buffer_sw_data_at(op->ddata, op->dfmt, 0, y0, &dat);
+	enesim_buffer_sw_data_at(op->sdata, op->sfmt, 0, y0, &sat);
+	if (op->dcnv)
+		op->dcnv(&dat, op->w, y1 - y0, &sat, op->x, op->y + y0);
+	else
+		op->cnv(&dat, op->w, y1 - y0, &sat, op->w, y1 - y0);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI _converter_thread_run(void *data)
+#else
+static void * _converter_thread_run(void *data)
+#endif
+{
+	Enesim_Converter_Thread *thiz = data;
+
+	do
+	{
+		enesim_barrier_wait(&_start);
+		if (thiz->done) break;
+		_converter_band(&_op, thiz->idx);
+		enesim_barrier_wait(&_end);
+	} while (1);
+
+#ifdef _WIN32
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+static void _converter_threads_setup(void)
+{
+	unsigned int i;
+
+	if (_threads) return;
+
+	_threads = malloc(sizeof(Enesim_Converter_Thread) * _num_threads);
+	enesim_barrier_new(&_start, _num_threads + 1);
+	enesim_barrier_new(&_end, _num_threads + 1);
+	for (i = 0; i < _num_threads; i++)
+	{
+		_threads[i].idx = i;
+		_threads[i].done = EINA_FALSE;
+		enesim_thread_new(&_threads[i].tid, _converter_thread_run, (void *)&_threads[i]);
+		enesim_thread_affinity_set(_threads[i].tid, i);
+	}
+}
+#endif
+
+/* big conversions are split on bands of rows converted by the worker
+ * threads, unless every row depends on the previous one
+ */
+static void _converter_run(Enesim_Converter_Operation *op, Eina_Bool bands)
+{
+#ifdef BUILD_MULTI_CORE
+	Enesim_Buffer_Sw_Data tmp;
+
+	if (!bands || _num_threads < 2 ||
+			(uint64_t)op->w * op->h < ENESIM_CONVERTER_THREADED_PIXELS)
+		goto single;
+	/* we need to address the rows of both buffers */
+	if (!enesim_buffer_sw_data_at(op->ddata, op->dfmt, 0, 0, &tmp) ||
+			!enesim_buffer_sw_data_at(op->sdata, op->sfmt, 0, 0, &tmp))
+		goto single;
+	/* in case other thread is converting, do not wait for it */
+	if (eina_lock_take_try(&_lock) != EINA_LOCK_SUCCEED)
+		goto single;
+
+	_converter_threads_setup();
+	_op = *op;
+	enesim_barrier_wait(&_start);
+	enesim_barrier_wait(&_end);
+	eina_lock_release(&_lock);
+	return;
+single:
+#else
+	(void)bands;
+#endif
+	if (op->dcnv)
+		op->dcnv(op->ddata, op->w, op->h, op->sdata, op->x, op->y);
+	else
+		op->cnv(op->ddata, op->w, op->h, op->sdata, op->w, op->h);
+}
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
 void enesim_converter_init(void)
 {
+#ifdef BUILD_MULTI_CORE
+	eina_lock_new(&_lock);
+	_num_threads = enesim_renderer_sw_cpu_count();
+#endif
 	enesim_converter_argb8888_init();
 	enesim_converter_xrgb8888_init();
 	enesim_converter_rgb888_init();
@@ -54,6 +200,24 @@ void enesim_converter_init(void)
 }
 void enesim_converter_shutdown(void)
 {
+#ifdef BUILD_MULTI_CORE
+	if (_threads)
+	{
+		unsigned int i;
+
+		/* mark all the threads to leave and make them start again */
+		for (i = 0; i < _num_threads; i++)
+			_threads[i].done = EINA_TRUE;
+		enesim_barrier_wait(&_start);
+		for (i = 0; i < _num_threads; i++)
+			enesim_thread_free(_threads[i].tid);
+		free(_threads);
+		_threads = NULL;
+		enesim_barrier_free(&_start);
+		enesim_barrier_free(&_end);
+	}
+	eina_lock_free(&_lock);
+#endif
 }
 
 void enesim_converter_surface_register(Enesim_Converter_2D cnv,
@@ -69,6 +233,67 @@ Enesim_Converter_2D enesim_converter_surface_get(Enesim_Buffer_Format dfmt,
 {
 	return _converters_2d[dfmt][angle][sfmt];
 }
+
+/* Convert the whole source into the destination */
+void enesim_converter_surface_convert(Enesim_Converter_2D cnv,
+		Enesim_Buffer_Sw_Data *ddata, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *sdata, Enesim_Buffer_Format sfmt,
+		uint32_t w, uint32_t h)
+{
+	Enesim_Converter_Operation op;
+
+	op.cnv = cnv;
+	op.dcnv = NULL;
+	op.ddata = ddata;
+	op.dfmt = dfmt;
+	op.sdata = sdata;
+	op.sfmt = sfmt;
+	op.x = 0;
+	op.y = 0;
+	op.w = w;
+	op.h = h;
+	_converter_run(&op, EINA_TRUE);
+}
+
+void enesim_converter_surface_dither_register(Enesim_Converter_2D_Dither cnv,
+		Enesim_Buffer_Format dfmt, Enesim_Buffer_Dither dither,
+		Enesim_Buffer_Format sfmt)
+{
+	_converters_2d_dither[dfmt][dither][sfmt] = cnv;
+}
+
+Enesim_Converter_2D_Dither enesim_converter_surface_dither_get(
+		Enesim_Buffer_Format dfmt, Enesim_Buffer_Dither dither,
+		Enesim_Buffer_Format sfmt)
+{
+	return _converters_2d_dither[dfmt][dither][sfmt];
+}
+
+/* Same as enesim_converter_surface_convert() but x and y are the position
+ * of the area to convert, the dither pattern is anchored to the origin of
+ * the buffer
+ */
+void enesim_converter_surface_dither_convert(Enesim_Converter_2D_Dither cnv,
+		Enesim_Buffer_Dither dither,
+		Enesim_Buffer_Sw_Data *ddata, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *sdata, Enesim_Buffer_Format sfmt,
+		int x, int y, uint32_t w, uint32_t h)
+{
+	Enesim_Converter_Operation op;
+
+	op.cnv = NULL;
+	op.dcnv = cnv;
+	op.ddata = ddata;
+	op.dfmt = dfmt;
+	op.sdata = sdata;
+	op.sfmt = sfmt;
+	op.x = x;
+	op.y = y;
+	op.w = w;
+	op.h = h;
+	/* the error diffusion goes through every row in order */
+	_converter_run(&op, dither == ENESIM_BUFFER_DITHER_ORDERED);
+}
 /** @endcond */
 /*============================================================================*
  *                                   API                                      *
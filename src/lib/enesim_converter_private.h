@@ -21,7 +21,12 @@
 typedef void (*Enesim_Converter_2D)(Enesim_Buffer_Sw_Data *ddata, uint32_t dw, uint32_t dh,
 		Enesim_Buffer_Sw_Data *sdata, uint32_t sw, uint32_t sh);
 
+/* x and y are the position of the destination data on its buffer */
+typedef void (*Enesim_Converter_2D_Dither)(Enesim_Buffer_Sw_Data *ddata, uint32_t dw, uint32_t dh,
+		Enesim_Buffer_Sw_Data *sdata, int x, int y);
+
 #define ENESIM_CONVERTER_2D(f) ((Enesim_Converter_2D)(f))
+#define ENESIM_CONVERTER_2D_DITHER(f) ((Enesim_Converter_2D_Dither)(f))
 
 void enesim_converter_init(void);
 void enesim_converter_shutdown(void);
@@ -38,5 +43,21 @@ void enesim_converter_surface_register(Enesim_Converter_2D cnv,
 
 Enesim_Converter_2D enesim_converter_surface_get(Enesim_Buffer_Format dfmt,
 		Enesim_Angle angle, Enesim_Buffer_Format sfmt);
+void enesim_converter_surface_convert(Enesim_Converter_2D cnv,
+		Enesim_Buffer_Sw_Data *ddata, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *sdata, Enesim_Buffer_Format sfmt,
+		uint32_t w, uint32_t h);
+
+void enesim_converter_surface_dither_register(Enesim_Converter_2D_Dither cnv,
+		Enesim_Buffer_Format dfmt, Enesim_Buffer_Dither dither,
+		Enesim_Buffer_Format sfmt);
+Enesim_Converter_2D_Dither enesim_converter_surface_dither_get(
+		Enesim_Buffer_Format dfmt, Enesim_Buffer_Dither dither,
+		Enesim_Buffer_Format sfmt);
+void enesim_converter_surface_dither_convert(Enesim_Converter_2D_Dither cnv,
+		Enesim_Buffer_Dither dither,
+		Enesim_Buffer_Sw_Data *ddata, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *sdata, Enesim_Buffer_Format sfmt,
+		int x, int y, uint32_t w, uint32_t h);
 
 #endif
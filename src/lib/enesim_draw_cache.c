@@ -154,6 +154,7 @@ Eina_Bool enesim_draw_cache_geometry_get(Enesim_Draw_Cache *thiz,
 }
 
 /* TODO we need to call the setup/cleanup first */
+/* the pool is only referenced in case the surface needs to be created */
 Eina_Bool enesim_draw_cache_setup_sw(Enesim_Draw_Cache *thiz,
 		Enesim_Format f, Enesim_Pool *p)
 {
@@ -216,7 +217,8 @@ Eina_Bool enesim_draw_cache_setup_sw(Enesim_Draw_Cache *thiz,
 		if (!thiz->s)
 		{
 			thiz->s = enesim_surface_new_pool_from(f,
-					thiz->bounds.w, thiz->bounds.h, p);
+					thiz->bounds.w, thiz->bounds.h,
+					enesim_pool_ref(p));
 		}
 		/* finally make the whole surface to be invalidated or pick
 		 * up the damages
@@ -245,6 +247,7 @@ Eina_Bool enesim_draw_cache_map_sw(Enesim_Draw_Cache *thiz,
 	Eina_Rectangle *rect;
 	Eina_Rectangle real_area;
 	Eina_Bool ret;
+	Eina_Bool hit = EINA_TRUE;
 
 	if (!thiz->r) return EINA_FALSE;
 
@@ -282,6 +285,7 @@ Eina_Bool enesim_draw_cache_map_sw(Enesim_Draw_Cache *thiz,
 
 		if (!eina_rectangle_intersection(&redraw, &real_area))
 			continue;
+		hit = EINA_FALSE;
 		dst = (uint8_t *)enesim_color_at(mapped->argb8888.plane0,
 				mapped->argb8888.plane0_stride,
 				redraw.x, redraw.y);
@@ -300,6 +304,12 @@ Eina_Bool enesim_draw_cache_map_sw(Enesim_Draw_Cache *thiz,
 	}
 	eina_iterator_free(it);
 	eina_lock_release(&thiz->tlock);
+#if BUILD_STATS
+	if (enesim_renderer_stats_enabled)
+		enesim_renderer_stats_cache_add(thiz->r, hit);
+#else
+	(void)hit;
+#endif
 
 	return ret;
 }
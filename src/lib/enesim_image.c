@@ -31,21 +31,104 @@
 /* @cond internal */
 #define ENESIM_LOG_DEFAULT enesim_log_image
 
+/* the number of bytes of the stream the magic numbers are checked against */
+#define ENESIM_IMAGE_MAGIC_HEADER 64
+
+/* the providers of a mime, with the resolution of the provider to use
+ * cached. The resolution is done again whenever the providers change
+ */
+typedef struct _Enesim_Image_Mime
+{
+	Eina_List *providers;
+	/* the first provider that can give the image information */
+	Enesim_Image_Provider *info;
+	/* the provider to use in case it does not need to check the data */
+	Enesim_Image_Provider *load;
+	Enesim_Image_Provider *save;
+} Enesim_Image_Mime;
+
+typedef struct _Enesim_Image_Magic
+{
+	Enesim_Image_Finder_Descriptor *f;
+	const char *mime;
+	unsigned char bytes[ENESIM_IMAGE_MAGIC_HEADER];
+	size_t len;
+	size_t offset;
+} Enesim_Image_Magic;
+
 static int _enesim_image_init_count = 0;
 static Eina_Array *_modules = NULL;
 static Eina_Hash *_providers = NULL;
 static Eina_List *_finders = NULL;
+static Eina_List *_magics = NULL;
 static Enesim_Image_Context *_main_context = NULL;
 
+static void _mime_resolve(Enesim_Image_Mime *m)
+{
+	Enesim_Image_Provider *p;
+	Eina_List *l;
+
+	m->info = NULL;
+	EINA_LIST_FOREACH (m->providers, l, p)
+	{
+		if (p->d->info_get)
+		{
+			m->info = p;
+			break;
+		}
+	}
+	p = eina_list_data_get(m->providers);
+	m->load = (p && !p->d->loadable) ? p : NULL;
+	m->save = (p && !p->d->saveable) ? p : NULL;
+}
+
+/* keep the providers sorted by priority, the ones with the same priority
+ * in the order they were added
+ */
+static void _mime_provider_insert(Enesim_Image_Mime *m,
+		Enesim_Image_Provider *p)
+{
+	Enesim_Image_Provider *pp;
+	Eina_List *l;
+
+	EINA_LIST_FOREACH (m->providers, l, pp)
+	{
+		if (pp->priority < p->priority)
+		{
+			m->providers = eina_list_prepend_relative_list(
+					m->providers, p, l);
+			return;
+		}
+	}
+	m->providers = eina_list_append(m->providers, p);
+}
+
+static void _mime_free(void *data)
+{
+	Enesim_Image_Mime *m = data;
+	Enesim_Image_Provider *p;
+
+	EINA_LIST_FREE(m->providers, p)
+		free(p);
+	free(m);
+}
+
+/* the longest magic numbers first, they are the most specific ones */
+static int _magic_cmp(const void *d1, const void *d2)
+{
+	const Enesim_Image_Magic *m1 = d1;
+	const Enesim_Image_Magic *m2 = d2;
+
+	return (int)m2->len - (int)m1->len;
+}
+
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
 Enesim_Image_Provider * enesim_image_load_info_provider_get(
 		Enesim_Stream *data, const char *mime)
 {
-	Enesim_Image_Provider *p;
-	Eina_List *providers;
-	Eina_List *l;
+	Enesim_Image_Mime *m;
 
 	if (!mime)
 	{
@@ -57,20 +140,17 @@ Enesim_Image_Provider * enesim_image_load_info_provider_get(
 		WRN("No mime type detected");
 		return NULL;
 	}
-	providers = eina_hash_find(_providers, mime);
-	EINA_LIST_FOREACH (providers, l, p)
-	{
-		if (p->d->info_get)
-			return p;
-	}
-	return NULL;
+	m = eina_hash_find(_providers, mime);
+	if (!m)
+		return NULL;
+	return m->info;
 }
 
 Enesim_Image_Provider * enesim_image_load_provider_get(Enesim_Stream *data,
 		const char *mime)
 {
 	Enesim_Image_Provider *p;
-	Eina_List *providers;
+	Enesim_Image_Mime *m;
 	Eina_List *l;
 
 	if (!mime)
@@ -83,9 +163,13 @@ Enesim_Image_Provider * enesim_image_load_provider_get(Enesim_Stream *data,
 		WRN("No mime type detected");
 		return NULL;
 	}
-	providers = eina_hash_find(_providers, mime);
+	m = eina_hash_find(_providers, mime);
+	if (!m)
+		return NULL;
+	if (m->load)
+		return m->load;
 	/* iterate over the list of providers and check for a compatible loader */
-	EINA_LIST_FOREACH (providers, l, p)
+	EINA_LIST_FOREACH (m->providers, l, p)
 	{
 		/* TODO priority loaders */
 		/* check if the provider can load the image */
@@ -106,12 +190,16 @@ Enesim_Image_Provider * enesim_image_save_provider_get(Enesim_Buffer *b,
 		const char *mime)
 {
 	Enesim_Image_Provider *p;
-	Eina_List *providers;
+	Enesim_Image_Mime *m;
 	Eina_List *l;
 
-	providers = eina_hash_find(_providers, mime);
+	m = eina_hash_find(_providers, mime);
+	if (!m)
+		return NULL;
+	if (m->save)
+		return m->save;
 	/* iterate over the list of providers and check for a compatible saver */
-	EINA_LIST_FOREACH (providers, l, p)
+	EINA_LIST_FOREACH (m->providers, l, p)
 	{
 		/* TODO priority savers */
 		/* check if the provider can save the image */
@@ -143,7 +231,7 @@ int enesim_image_init(void)
 	ENESIM_IMAGE_ERROR_LOADING = eina_error_msg_static_register("Error loading the image");
 	ENESIM_IMAGE_ERROR_SAVING = eina_error_msg_static_register("Error saving the image");
 	/* the providers */
-	_providers = eina_hash_string_superfast_new(NULL);
+	_providers = eina_hash_string_superfast_new(_mime_free);
 	/* the modules */
 	_modules = eina_module_list_get(_modules, PACKAGE_LIB_DIR"/enesim/image/", 1, NULL, NULL);
 	eina_module_list_load(_modules);
@@ -187,7 +275,12 @@ int enesim_image_shutdown(void)
 	eina_module_list_free(_modules);
 	eina_array_free(_modules);
 	/* remove the finders */
-	eina_list_free(_finders);
+	_finders = eina_list_free(_finders);
+	while (_magics)
+	{
+		free(eina_list_data_get(_magics));
+		_magics = eina_list_remove_list(_magics, _magics);
+	}
 	/* remove the providers */
 	eina_hash_free(_providers);
 
@@ -321,8 +414,7 @@ EAPI Eina_Bool enesim_image_provider_register(Enesim_Image_Provider_Descriptor *
 		Enesim_Priority priority, const char *mime)
 {
 	Enesim_Image_Provider *p;
-	Eina_List *providers;
-	Eina_List *tmp;
+	Enesim_Image_Mime *m;
 
 	if (!pd)
 		return EINA_FALSE;
@@ -342,13 +434,14 @@ EAPI Eina_Bool enesim_image_provider_register(Enesim_Image_Provider_Descriptor *
 	p->mime = mime;
 	p->d = pd;
 
-	providers = tmp = eina_hash_find(_providers, mime);
-	/* TODO add to the list in order */
-	providers = eina_list_append(providers, p);
-	if (!tmp)
+	m = eina_hash_find(_providers, mime);
+	if (!m)
 	{
-		eina_hash_add(_providers, mime, providers);
+		m = calloc(1, sizeof(Enesim_Image_Mime));
+		eina_hash_add(_providers, mime, m);
 	}
+	_mime_provider_insert(m, p);
+	_mime_resolve(m);
 	return EINA_TRUE;
 }
 
@@ -358,28 +451,16 @@ EAPI Eina_Bool enesim_image_provider_register(Enesim_Image_Provider_Descriptor *
 EAPI void enesim_image_provider_priority_set(Enesim_Image_Provider *p,
 		Enesim_Priority priority)
 {
-	Enesim_Image_Provider *pp;
-	Eina_List *providers;
-	Eina_List *l, *rel = NULL, *tmp;
+	Enesim_Image_Mime *m;
 
 	p->priority = priority;
 	/* reorder the list */
-	providers = eina_hash_find(_providers, p->mime);
-	providers = tmp = eina_list_remove(providers, p);
-
-	EINA_LIST_FOREACH (providers, l, pp)
-	{
-		if (pp->priority <= priority)
-		{
-			rel = l;
-			break;
-		}
-	}
-	providers = eina_list_prepend_relative_list(providers, p, rel);
-	if (!tmp)
-	{
-		eina_hash_add(_providers, p->mime, providers);
-	}
+	m = eina_hash_find(_providers, p->mime);
+	if (!m)
+		return;
+	m->providers = eina_list_remove(m->providers, p);
+	_mime_provider_insert(m, p);
+	_mime_resolve(m);
 }
 
 /**
@@ -388,33 +469,32 @@ EAPI void enesim_image_provider_priority_set(Enesim_Image_Provider *p,
 EAPI void enesim_image_provider_unregister(Enesim_Image_Provider_Descriptor *pd, const char *mime)
 {
 	Enesim_Image_Provider *p;
-	Eina_List *providers;
-	Eina_List *tmp;
+	Enesim_Image_Mime *m;
 	Eina_List *l;
 
-	providers = tmp = eina_hash_find(_providers, mime);
-	if (!providers)
+	m = eina_hash_find(_providers, mime);
+	if (!m)
 	{
 		WRN("Impossible to unregister the provider %p on mime '%s'", pd, mime);
 		return;
 	}
 	/* find the provider for this mime list */
-	EINA_LIST_FOREACH(providers, l, p)
+	EINA_LIST_FOREACH(m->providers, l, p)
 	{
 		if (p->d != pd)
 			continue;
 
 		/* remove from the list of providers */
-		providers = eina_list_remove(providers, p);
-		if (!providers)
-		{
-			eina_hash_del(_providers, mime, tmp);
-		}
+		m->providers = eina_list_remove_list(m->providers, l);
 		/* finally free the provider itself */
 		free(p);
 
 		break;
 	}
+	if (!m->providers)
+		eina_hash_del(_providers, mime, m);
+	else
+		_mime_resolve(m);
 }
 
 /**
@@ -423,9 +503,30 @@ EAPI void enesim_image_provider_unregister(Enesim_Image_Provider_Descriptor *pd,
 EAPI const char * enesim_image_mime_data_from(Enesim_Stream *data)
 {
 	Enesim_Image_Finder_Descriptor *f;
+	Enesim_Image_Magic *m;
 	Eina_List *l;
 	const char *ret = NULL;
 
+	/* first check every magic number against the header in one pass */
+	if (_magics)
+	{
+		unsigned char header[ENESIM_IMAGE_MAGIC_HEADER];
+		ssize_t len;
+
+		enesim_stream_reset(data);
+		len = enesim_stream_read(data, header, ENESIM_IMAGE_MAGIC_HEADER);
+		EINA_LIST_FOREACH(_magics, l, m)
+		{
+			if (len < 0 || m->offset + m->len > (size_t)len)
+				continue;
+			if (!memcmp(header + m->offset, m->bytes, m->len))
+			{
+				ret = m->mime;
+				goto done;
+			}
+		}
+	}
+	/* now ask every finder */
 	EINA_LIST_FOREACH(_finders, l, f)
 	{
 		if (!f->data_from)
@@ -435,6 +536,7 @@ EAPI const char * enesim_image_mime_data_from(Enesim_Stream *data)
 		ret = f->data_from(data);
 		if (ret) break;
 	}
+done:
 	DBG("Using mime '%s'", ret);
 	return ret;
 }
@@ -478,8 +580,57 @@ EAPI Eina_Bool enesim_image_finder_register(Enesim_Image_Finder_Descriptor *f)
 
 EAPI void enesim_image_finder_unregister(Enesim_Image_Finder_Descriptor *f)
 {
+	Enesim_Image_Magic *m;
+	Eina_List *l, *l_next;
+
 	if (!f) return;
 	_finders = eina_list_remove(_finders, f);
+	/* remove the magic numbers of the finder too */
+	EINA_LIST_FOREACH_SAFE(_magics, l, l_next, m)
+	{
+		if (m->f != f)
+			continue;
+		_magics = eina_list_remove_list(_magics, l);
+		free(m);
+	}
+}
+
+/**
+ * @brief Registers a magic number that identifies the data of a mime type
+ * @param[in] f The finder the magic number belongs to
+ * @param[in] mime The mime type the magic number identifies
+ * @param[in] magic The bytes of the magic number
+ * @param[in] len The number of bytes of the magic number
+ * @param[in] offset The position of the magic number on the data
+ * @return EINA_TRUE if the magic number is registered, EINA_FALSE otherwise
+ *
+ * Every registered magic number is checked against the start of the data
+ * at once, before asking the finders with the data_from() function. The
+ * magic number and its offset must fit on the first 64 bytes of the data.
+ * The magic numbers are unregistered together with the finder.
+ */
+EAPI Eina_Bool enesim_image_finder_magic_register(
+		Enesim_Image_Finder_Descriptor *f, const char *mime,
+		const void *magic, size_t len, size_t offset)
+{
+	Enesim_Image_Magic *m;
+
+	if (!f || !mime || !magic || !len) return EINA_FALSE;
+	if (offset + len > ENESIM_IMAGE_MAGIC_HEADER)
+	{
+		WRN("Magic number for mime '%s' out of the header", mime);
+		return EINA_FALSE;
+	}
+
+	m = calloc(1, sizeof(Enesim_Image_Magic));
+	m->f = f;
+	m->mime = mime;
+	memcpy(m->bytes, magic, len);
+	m->len = len;
+	m->offset = offset;
+	_magics = eina_list_sorted_insert(_magics, _magic_cmp, m);
+
+	return EINA_TRUE;
 }
 
 /**
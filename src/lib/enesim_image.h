@@ -262,6 +262,9 @@ typedef struct _Enesim_Image_Finder_Descriptor
 
 EAPI Eina_Bool enesim_image_finder_register(Enesim_Image_Finder_Descriptor *f);
 EAPI void enesim_image_finder_unregister(Enesim_Image_Finder_Descriptor *f);
+EAPI Eina_Bool enesim_image_finder_magic_register(
+		Enesim_Image_Finder_Descriptor *f, const char *mime,
+		const void *magic, size_t len, size_t offset);
 
 /**
  * @}
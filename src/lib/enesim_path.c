@@ -206,6 +206,69 @@ void enesim_path_command_get(Enesim_Path *thiz,
 	}
 }
 
+/* append the commands of another path translated by tx, ty */
+void enesim_path_translated_add(Enesim_Path *thiz, const Enesim_Path *src,
+		double tx, double ty)
+{
+	Enesim_Path_Command *cmd;
+	Eina_List *l;
+
+	EINA_LIST_FOREACH(src->commands, l, cmd)
+	{
+		Enesim_Path_Command c = *cmd;
+
+		switch (c.type)
+		{
+			case ENESIM_PATH_COMMAND_TYPE_MOVE_TO:
+			c.data.move_to.x += tx;
+			c.data.move_to.y += ty;
+			break;
+
+			case ENESIM_PATH_COMMAND_TYPE_LINE_TO:
+			c.data.line_to.x += tx;
+			c.data.line_to.y += ty;
+			break;
+
+			case ENESIM_PATH_COMMAND_TYPE_QUADRATIC_TO:
+			c.data.quadratic_to.x += tx;
+			c.data.quadratic_to.y += ty;
+			c.data.quadratic_to.ctrl_x += tx;
+			c.data.quadratic_to.ctrl_y += ty;
+			break;
+
+			case ENESIM_PATH_COMMAND_TYPE_SQUADRATIC_TO:
+			c.data.squadratic_to.x += tx;
+			c.data.squadratic_to.y += ty;
+			break;
+
+			case ENESIM_PATH_COMMAND_TYPE_CUBIC_TO:
+			c.data.cubic_to.x += tx;
+			c.data.cubic_to.y += ty;
+			c.data.cubic_to.ctrl_x0 += tx;
+			c.data.cubic_to.ctrl_y0 += ty;
+			c.data.cubic_to.ctrl_x1 += tx;
+			c.data.cubic_to.ctrl_y1 += ty;
+			break;
+
+			case ENESIM_PATH_COMMAND_TYPE_SCUBIC_TO:
+			c.data.scubic_to.x += tx;
+			c.data.scubic_to.y += ty;
+			c.data.scubic_to.ctrl_x += tx;
+			c.data.scubic_to.ctrl_y += ty;
+			break;
+
+			case ENESIM_PATH_COMMAND_TYPE_ARC_TO:
+			c.data.arc_to.x += tx;
+			c.data.arc_to.y += ty;
+			break;
+
+			default:
+			break;
+		}
+		enesim_path_command_add(thiz, &c);
+	}
+}
+
 int enesim_path_changed(Enesim_Path *thiz)
 {
 	return thiz->changed;
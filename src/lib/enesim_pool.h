@@ -61,6 +61,30 @@ EAPI Enesim_Pool * enesim_pool_sw_new(void);
 
 EAPI Enesim_Pool * enesim_pool_eina_new(Eina_Mempool *mp);
 
+/**
+ * @}
+ * @defgroup Enesim_Pool_Recycle Recycle Pool
+ * @ingroup Enesim_Pool
+ * @brief Sw pool that reuses the memory of the freed buffers @ender_inherits{Enesim_Pool}
+ * @{
+ */
+
+EAPI Enesim_Pool * enesim_pool_recycle_new(size_t max);
+EAPI void enesim_pool_recycle_clear_set(Enesim_Pool *p, Eina_Bool clear);
+EAPI void enesim_pool_recycle_stats_get(Enesim_Pool *p, unsigned int *hits,
+		unsigned int *misses, size_t *memory);
+EAPI void enesim_pool_recycle_flush(Enesim_Pool *p);
+
+/**
+ * @}
+ * @defgroup Enesim_Pool_Mmap Mmap Pool
+ * @ingroup Enesim_Pool
+ * @brief Sw pool that maps the memory of the big buffers @ender_inherits{Enesim_Pool}
+ * @{
+ */
+
+EAPI Enesim_Pool * enesim_pool_mmap_new(size_t threshold);
+
 /** @} */
 
 #endif
@@ -31,6 +31,8 @@
 #include "enesim_object_class.h"
 #include "enesim_object_instance.h"
 
+#include "enesim_color_private.h"
+#include "enesim_buffer_private.h"
 #include "enesim_surface_private.h"
 #include "enesim_renderer_private.h"
 /**
@@ -97,6 +99,31 @@ static inline Eina_Bool _enesim_renderer_destination_bounds_get(Enesim_Renderer
 	enesim_rectangle_normalize(&obounds, bounds);
 	return EINA_TRUE;
 }
+
+static inline Eina_Bool _enesim_renderer_opaque_bounds_get(Enesim_Renderer *r,
+		Eina_Rectangle *dbounds, Eina_Rectangle *bounds)
+{
+	Enesim_Renderer_Class *klass = ENESIM_RENDERER_CLASS_GET(r);
+
+	/* the common properties that make a renderer not opaque */
+	if (!klass->opaque_bounds_get)
+		goto none;
+	if (!r->state.current.visibility)
+		goto none;
+	if (enesim_color_alpha_get(r->state.current.color) != 0xff)
+		goto none;
+	if (r->state.current.mask)
+		goto none;
+	if (!klass->opaque_bounds_get(r, bounds))
+		goto none;
+	/* never go outside the bounds */
+	if (!eina_rectangle_intersection(bounds, dbounds))
+		goto none;
+	return EINA_TRUE;
+none:
+	eina_rectangle_coords_from(bounds, 0, 0, 0, 0);
+	return EINA_FALSE;
+}
 /*----------------------------------------------------------------------------*
  *                     Internal state related functions                       *
  *----------------------------------------------------------------------------*/
@@ -367,6 +394,9 @@ static void _enesim_renderer_instance_init(void *o)
 	eina_rectangle_coords_from(&thiz->past_destination_bounds, INT_MIN / 2, INT_MIN / 2, INT_MAX, INT_MAX);
 	thiz->prv_data = eina_hash_string_superfast_new(NULL);
 	eina_lock_new(&thiz->lock);
+#if BUILD_STATS
+	enesim_renderer_stats_data_init(thiz);
+#endif
 	/* always set the first reference */
 	thiz = enesim_renderer_ref(thiz);
 	_enesim_renderer_factory_setup(thiz);
@@ -377,6 +407,9 @@ static void _enesim_renderer_instance_deinit(void *o)
 	Enesim_Renderer *thiz = ENESIM_RENDERER(o);
 
 	eina_lock_free(&thiz->lock);
+#if BUILD_STATS
+	enesim_renderer_stats_data_shutdown(thiz);
+#endif
 	eina_hash_free(thiz->prv_data);
 	/* remove all the private data */
 	enesim_renderer_sw_free(thiz);
@@ -402,6 +435,7 @@ void enesim_renderer_init(void)
 {
 	_factories = eina_hash_string_superfast_new(
 			_enesim_renderer_factory_free);
+	enesim_renderer_stats_init();
 	enesim_renderer_sw_init();
 #if BUILD_OPENCL
 	enesim_renderer_opencl_init();
@@ -420,6 +454,7 @@ void enesim_renderer_shutdown(void)
 #if BUILD_OPENGL
 	enesim_renderer_opengl_shutdown();
 #endif
+	enesim_renderer_stats_shutdown();
 	eina_hash_free(_factories);
 	_factories = NULL;
 }
@@ -499,6 +534,9 @@ Eina_Bool enesim_renderer_setup(Enesim_Renderer *r, Enesim_Surface *s,
 {
 	Enesim_Backend b;
 	Eina_Bool ret = EINA_TRUE;
+#if BUILD_STATS
+	uint64_t t = 0;
+#endif
 
 	ENESIM_MAGIC_CHECK_RENDERER(r);
 	DBG("Setting up the renderer '%s' with rop %d", r->name, rop);
@@ -508,6 +546,10 @@ Eina_Bool enesim_renderer_setup(Enesim_Renderer *r, Enesim_Surface *s,
 		return EINA_TRUE;
 	}
 	enesim_renderer_lock(r);
+#if BUILD_STATS
+	if (enesim_renderer_stats_enabled)
+		t = enesim_renderer_stats_time_get();
+#endif
 
 	b = enesim_surface_backend_get(s);
 	switch (b)
@@ -553,8 +595,17 @@ Eina_Bool enesim_renderer_setup(Enesim_Renderer *r, Enesim_Surface *s,
 		 */
 		_enesim_renderer_bounds_get(r, &r->current_bounds, log);
 		enesim_rectangle_normalize(&r->current_bounds, &r->current_destination_bounds);
+		_enesim_renderer_opaque_bounds_get(r, &r->current_destination_bounds,
+				&r->current_opaque_bounds);
 		r->current_features = enesim_renderer_features_get(r);
 		r->current_rop = rop;
+		if (b == ENESIM_BACKEND_SOFTWARE)
+			enesim_renderer_sw_delegate_collapse(r);
+#if BUILD_STATS
+		if (t)
+			enesim_renderer_stats_setup_add(r,
+					enesim_renderer_stats_time_get() - t);
+#endif
 	}
 	else
 	{
@@ -1202,6 +1253,49 @@ EAPI Eina_Bool enesim_renderer_destination_bounds_get_extended(Enesim_Renderer *
 	return ret;
 }
 
+/**
+ * @brief Gets the area of the renderer on the destination coordinate space
+ * where every pixel is fully opaque
+ * @param[in] r The renderer to get the opaque bounds from
+ * @param[out] rect The rectangle to store the opaque bounds
+ * @param[in] x The x destination origin
+ * @param[in] y The y destination origin
+ * @return EINA_TRUE if the renderer has an opaque area, EINA_FALSE otherwise
+ *
+ * The opaque bounds are always inside the destination bounds. A renderer
+ * is never opaque if it has a mask, is not visible or its color is not
+ * fully opaque. Drawing a fully opaque area with the @ref ENESIM_ROP_BLEND
+ * raster operation is the same as drawing it with @ref ENESIM_ROP_FILL, so
+ * everything below it can be skipped
+ */
+EAPI Eina_Bool enesim_renderer_opaque_bounds_get(Enesim_Renderer *r,
+		Eina_Rectangle *rect, int x, int y)
+{
+	Eina_Bool ret = EINA_TRUE;
+	ENESIM_MAGIC_CHECK_RENDERER(r);
+
+	if (!rect) return EINA_FALSE;
+	if (r->in_setup || !enesim_renderer_has_changed(r))
+	{
+		*rect = r->current_opaque_bounds;
+		ret = eina_rectangle_is_valid(rect);
+	}
+	else
+	{
+		Eina_Rectangle dbounds;
+
+		if (!_enesim_renderer_destination_bounds_get(r, &dbounds, NULL))
+			return EINA_FALSE;
+		ret = _enesim_renderer_opaque_bounds_get(r, &dbounds, rect);
+	}
+	if (!ret) return EINA_FALSE;
+	if (rect->x != INT_MIN / 2)
+		rect->x -= x;
+	if (rect->y != INT_MIN / 2)
+		rect->y -= y;
+	return EINA_TRUE;
+}
+
 EAPI Eina_Bool enesim_renderer_is_inside(Enesim_Renderer *r, double x, double y)
 {
 	Enesim_Renderer_Class *klass;
@@ -1333,6 +1427,99 @@ end:
 	return ret;
 }
 
+/**
+ * Draw a renderer into a buffer of any format
+ * @param[in] r The renderer to draw
+ * @param[in] b The buffer to draw the renderer into
+ * @param[in] clips A list of clipping areas on the destination buffer to limit the drawing. @ender_nullable
+ * @param[in] x The x origin of the destination buffer
+ * @param[in] y The y origin of the destination buffer
+ * @param[out] log In case the drawing fails, the log to put messages on. @ender_nullable
+ * @return EINA_TRUE if the the drawing was successfull, EINA_FALSE otherwise.
+ * In case the drawing fails the @p log is filled with the failed message
+ *
+ * Every span is drawn into a small ARGB8888 row and converted into the
+ * format of the buffer right away, instead of drawing the whole area into a
+ * surface and converting it later with enesim_surface_convert_list(). The
+ * buffer must be a software buffer with a format an ARGB8888 surface can be
+ * converted to. The area is always drawn with the @ref ENESIM_ROP_FILL
+ * raster operation, as the buffer can not be composed.
+ */
+EAPI Eina_Bool enesim_renderer_draw_buffer_list(Enesim_Renderer *r,
+		Enesim_Buffer *b, Eina_List *clips, int x, int y,
+		Enesim_Log **log)
+{
+	Enesim_Converter_2D cnv;
+	Enesim_Buffer_Format dfmt;
+	Enesim_Buffer_Sw_Data ddata;
+	Enesim_Surface *s;
+	Eina_Rectangle buffer_size;
+	Eina_Rectangle *clip;
+	Eina_List *l;
+	Eina_Bool ret = EINA_FALSE;
+	int w, h;
+
+	ENESIM_MAGIC_CHECK_RENDERER(r);
+
+	if (enesim_buffer_backend_get(b) != ENESIM_BACKEND_SOFTWARE)
+	{
+		ENESIM_RENDERER_LOG(r, log, "Only software buffers can be drawn");
+		return EINA_FALSE;
+	}
+	dfmt = enesim_buffer_format_get(b);
+	cnv = enesim_converter_surface_get(dfmt, ENESIM_ANGLE_NONE,
+			ENESIM_BUFFER_FORMAT_ARGB8888_PRE);
+	if (!cnv)
+	{
+		ENESIM_RENDERER_LOG(r, log, "No converter for the buffer format %d",
+				dfmt);
+		return EINA_FALSE;
+	}
+
+	/* the surface is only used for the setup, the spans are drawn on
+	 * scratch rows
+	 */
+	enesim_buffer_size_get(b, &w, &h);
+	s = enesim_surface_new(ENESIM_FORMAT_ARGB8888, w, 1);
+	if (!s)
+		return EINA_FALSE;
+
+	if (!enesim_renderer_setup(r, s, ENESIM_ROP_FILL, log))
+		goto end;
+
+	enesim_buffer_lock(b, EINA_TRUE);
+	if (!enesim_buffer_map(b, &ddata))
+	{
+		enesim_buffer_unlock(b);
+		goto end;
+	}
+
+	eina_rectangle_coords_from(&buffer_size, 0, 0, w, h);
+	if (!clips)
+	{
+		enesim_renderer_sw_draw_buffer_area(r, cnv, dfmt, &ddata,
+				&buffer_size, x, y);
+	}
+	EINA_LIST_FOREACH(clips, l, clip)
+	{
+		Eina_Rectangle final;
+
+		final = *clip;
+		if (!eina_rectangle_intersection(&final, &buffer_size))
+			continue;
+		enesim_renderer_sw_draw_buffer_area(r, cnv, dfmt, &ddata,
+				&final, x, y);
+	}
+	enesim_buffer_unmap(b, &ddata, EINA_TRUE);
+	enesim_buffer_unlock(b);
+	ret = EINA_TRUE;
+end:
+	enesim_renderer_cleanup(r, s);
+	enesim_surface_unref(s);
+
+	return ret;
+}
+
 #if 0
 /**
  * To  be documented
@@ -71,6 +71,23 @@ typedef enum _Enesim_Renderer_Feature
  */
 typedef Eina_Bool (*Enesim_Renderer_Damage)(Enesim_Renderer *r, const Eina_Rectangle *area, Eina_Bool past, void *data);
 
+/**
+ * Statistics recorded on a renderer while drawing. All the times are in
+ * nanoseconds
+ * @see enesim_renderer_stats_get()
+ */
+typedef struct _Enesim_Renderer_Stats
+{
+	unsigned int setups; /**< Number of setups done */
+	uint64_t setup_time; /**< Time spent on the setup */
+	uint64_t spans; /**< Number of spans filled */
+	uint64_t pixels; /**< Number of pixels filled */
+	uint64_t fill_time; /**< Time spent on the fill function */
+	uint64_t span_time; /**< Time spent on the compositor span */
+	unsigned int cache_hits; /**< Number of draws served from a cache */
+	unsigned int cache_misses; /**< Number of draws that had to update a cache */
+} Enesim_Renderer_Stats;
+
 /**
  * @}
  * @defgroup Enesim_Renderer Renderer
@@ -122,6 +139,8 @@ EAPI Eina_Bool enesim_renderer_destination_bounds_get(Enesim_Renderer *r,
 		Eina_Rectangle *rect, int x, int y, Enesim_Log **log);
 EAPI Eina_Bool enesim_renderer_destination_bounds_get_extended(Enesim_Renderer *r,
 		Eina_Rectangle *prev, Eina_Rectangle *curr, int x, int y, Enesim_Log **log);
+EAPI Eina_Bool enesim_renderer_opaque_bounds_get(Enesim_Renderer *r,
+		Eina_Rectangle *rect, int x, int y);
 
 EAPI int enesim_renderer_features_get(Enesim_Renderer *r);
 EAPI Eina_Bool enesim_renderer_is_inside(Enesim_Renderer *r, double x, double y);
@@ -132,10 +151,19 @@ EAPI Eina_Bool enesim_renderer_draw(Enesim_Renderer *r, Enesim_Surface *s,
 		Enesim_Rop rop, Eina_Rectangle *clip, int x, int y, Enesim_Log **log);
 EAPI Eina_Bool enesim_renderer_draw_list(Enesim_Renderer *r, Enesim_Surface *s,
 		Enesim_Rop rop, Eina_List *clips, int x, int y, Enesim_Log **log);
+EAPI Eina_Bool enesim_renderer_draw_buffer_list(Enesim_Renderer *r,
+		Enesim_Buffer *b, Eina_List *clips, int x, int y,
+		Enesim_Log **log);
 
 EAPI void enesim_renderer_default_quality_set(Enesim_Quality quality);
 EAPI Eina_Bool enesim_renderer_type_get(Enesim_Renderer *r, const char **lib, char **name);
 
+EAPI void enesim_renderer_stats_enable_set(Eina_Bool enable);
+EAPI Eina_Bool enesim_renderer_stats_enable_get(void);
+EAPI Eina_Bool enesim_renderer_stats_get(Enesim_Renderer *r, Enesim_Renderer_Stats *stats);
+EAPI void enesim_renderer_stats_reset(Enesim_Renderer *r);
+EAPI void enesim_renderer_stats_dump(Enesim_Renderer *r, FILE *f);
+
 /**
  * @}
  */
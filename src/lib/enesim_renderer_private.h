@@ -33,6 +33,7 @@
 #include "enesim_renderer_opencl_private.h"
 #endif
 #include "enesim_renderer_opengl_private.h"
+#include "enesim_renderer_stats_private.h"
 
 Enesim_Object_Descriptor * enesim_renderer_descriptor_get(void);
 #define ENESIM_RENDERER_DESCRIPTOR enesim_renderer_descriptor_get()
@@ -77,6 +78,12 @@ typedef const char * (*Enesim_Renderer_Base_Name_Get_Cb)(Enesim_Renderer *r);
 typedef Eina_Bool (*Enesim_Renderer_Is_Supported_Cb)(Enesim_Renderer *r, Enesim_Surface *s);
 typedef Eina_Bool (*Enesim_Renderer_Is_Inside_Cb)(Enesim_Renderer *r, double x, double y);
 typedef Enesim_Alpha_Hint (*Enesim_Renderer_Alpha_Hints_Get_Cb)(Enesim_Renderer *r);
+/* The area on the destination coordinate space where every drawn pixel is
+ * fully opaque. Only the renderer specific properties must be taken into
+ * account, the common ones like the color or the mask are handled already
+ */
+typedef Eina_Bool (*Enesim_Renderer_Opaque_Bounds_Get_Cb)(Enesim_Renderer *r,
+		Eina_Rectangle *rect);
 typedef Eina_Bool (*Enesim_Renderer_Bounds_Get_Cb)(Enesim_Renderer *r,
 		Enesim_Rectangle *rect, Enesim_Log **error);
 typedef void (*Enesim_Renderer_Features_Get)(Enesim_Renderer *r,
@@ -136,10 +143,12 @@ typedef struct _Enesim_Renderer_Class
 	Enesim_Renderer_Damages_Get_Cb damages_get;
 	Enesim_Renderer_Has_Changed_Cb has_changed;
 	Enesim_Renderer_Alpha_Hints_Get_Cb alpha_hints_get;
+	Enesim_Renderer_Opaque_Bounds_Get_Cb opaque_bounds_get;
 	/* software based functions */
 	Enesim_Renderer_Sw_Hints_Get_Cb sw_hints_get;
 	Enesim_Renderer_Sw_Setup sw_setup;
 	Enesim_Renderer_Sw_Cleanup sw_cleanup;
+	Enesim_Renderer_Sw_Runs_Get sw_runs_get;
 #if BUILD_OPENCL
 	/* opencl based functions */
 	Enesim_Renderer_OpenCL_Setup opencl_setup;
@@ -175,6 +184,7 @@ struct _Enesim_Renderer
 	Enesim_Rectangle past_bounds;
 	Eina_Rectangle current_destination_bounds;
 	Eina_Rectangle past_destination_bounds;
+	Eina_Rectangle current_opaque_bounds;
 	Enesim_Rop current_rop;
 	char *name;
 	Enesim_Renderer_State state;
@@ -187,6 +197,9 @@ struct _Enesim_Renderer
 #if BUILD_OPENCL
 	cl_mem cl_matrix;
 #endif
+#if BUILD_STATS
+	Enesim_Renderer_Stats_Data stats;
+#endif
 };
 
 void enesim_renderer_init(void);
@@ -0,0 +1,336 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_private.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#if BUILD_STATS && !defined(_WIN32)
+#include <time.h>
+#endif
+
+#include "enesim_main.h"
+#include "enesim_log.h"
+#include "enesim_color.h"
+#include "enesim_rectangle.h"
+#include "enesim_matrix.h"
+#include "enesim_pool.h"
+#include "enesim_buffer.h"
+#include "enesim_format.h"
+#include "enesim_surface.h"
+#include "enesim_renderer.h"
+#include "enesim_object_descriptor.h"
+#include "enesim_object_class.h"
+#include "enesim_object_instance.h"
+
+#include "enesim_renderer_private.h"
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+/** @cond internal */
+#define ENESIM_LOG_DEFAULT enesim_log_renderer
+
+#if BUILD_STATS
+/* the renderers that have recorded something, used for the dump */
+static Eina_List *_renderers = NULL;
+static Eina_Lock _renderers_lock;
+static Eina_Bool _initialized = EINA_FALSE;
+
+/* the fill and span counters are updated from every drawing thread on every
+ * span, use atomic adds there instead of the renderer lock to not serialize
+ * the threads
+ */
+#if defined(__GNUC__)
+#define _stats_atomic_add(r, v, n) \
+	__atomic_fetch_add(&(r)->stats.stats.v, (n), __ATOMIC_RELAXED)
+#define _stats_registered_get(r) \
+	__atomic_load_n(&(r)->stats.registered, __ATOMIC_ACQUIRE)
+#else
+#define _stats_atomic_add(r, v, n) \
+	do { \
+		eina_lock_take(&(r)->stats.lock); \
+		(r)->stats.stats.v += (n); \
+		eina_lock_release(&(r)->stats.lock); \
+	} while (0)
+#define _stats_registered_get(r) ((r)->stats.registered)
+#endif
+
+#ifdef _WIN32
+static LARGE_INTEGER _frequency;
+#endif
+
+/* the dump takes the list lock and then the renderer lock, so never
+ * register while holding the renderer lock
+ */
+static inline void _stats_register(Enesim_Renderer *r)
+{
+	if (_stats_registered_get(r)) return;
+
+	eina_lock_take(&_renderers_lock);
+	if (_initialized && !r->stats.registered)
+	{
+		_renderers = eina_list_append(_renderers, r);
+		r->stats.registered = EINA_TRUE;
+	}
+	eina_lock_release(&_renderers_lock);
+}
+
+static void _stats_dump(Enesim_Renderer *r, FILE *f)
+{
+	Enesim_Renderer_Stats *s;
+
+	eina_lock_take(&r->stats.lock);
+	s = &r->stats.stats;
+	fprintf(f, "%-24s %8u %12.3f %10" PRIu64 " %12" PRIu64 " %12.3f %12.3f "
+			"%8u %8u\n",
+			r->name ? r->name : "(null)",
+			s->setups, s->setup_time / 1000000.0,
+			s->spans, s->pixels,
+			s->fill_time / 1000000.0, s->span_time / 1000000.0,
+			s->cache_hits, s->cache_misses);
+	eina_lock_release(&r->stats.lock);
+}
+#endif
+/** @endcond */
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+#if BUILD_STATS
+Eina_Bool enesim_renderer_stats_enabled = EINA_FALSE;
+
+uint64_t enesim_renderer_stats_time_get(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER now;
+
+	QueryPerformanceCounter(&now);
+	return (uint64_t)((now.QuadPart * 1000000000.0) / _frequency.QuadPart);
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+void enesim_renderer_stats_data_init(Enesim_Renderer *r)
+{
+	memset(&r->stats.stats, 0, sizeof(Enesim_Renderer_Stats));
+	r->stats.registered = EINA_FALSE;
+	eina_lock_new(&r->stats.lock);
+}
+
+void enesim_renderer_stats_data_shutdown(Enesim_Renderer *r)
+{
+	/* the list is gone in case enesim has been shutdown already */
+	if (_initialized && r->stats.registered)
+	{
+		eina_lock_take(&_renderers_lock);
+		_renderers = eina_list_remove(_renderers, r);
+		eina_lock_release(&_renderers_lock);
+	}
+	eina_lock_free(&r->stats.lock);
+}
+
+void enesim_renderer_stats_setup_add(Enesim_Renderer *r, uint64_t t)
+{
+	_stats_register(r);
+	eina_lock_take(&r->stats.lock);
+	r->stats.stats.setups++;
+	r->stats.stats.setup_time += t;
+	eina_lock_release(&r->stats.lock);
+}
+
+void enesim_renderer_stats_fill_add(Enesim_Renderer *r, int len, uint64_t t)
+{
+	_stats_register(r);
+	_stats_atomic_add(r, spans, 1);
+	_stats_atomic_add(r, pixels, len);
+	_stats_atomic_add(r, fill_time, t);
+}
+
+void enesim_renderer_stats_span_add(Enesim_Renderer *r, uint64_t t)
+{
+	_stats_atomic_add(r, span_time, t);
+}
+
+void enesim_renderer_stats_cache_add(Enesim_Renderer *r, Eina_Bool hit)
+{
+	_stats_register(r);
+	eina_lock_take(&r->stats.lock);
+	if (hit)
+		r->stats.stats.cache_hits++;
+	else
+		r->stats.stats.cache_misses++;
+	eina_lock_release(&r->stats.lock);
+}
+#endif
+
+void enesim_renderer_stats_init(void)
+{
+#if BUILD_STATS
+	const char *env;
+
+#ifdef _WIN32
+	QueryPerformanceFrequency(&_frequency);
+#endif
+	eina_lock_new(&_renderers_lock);
+	_initialized = EINA_TRUE;
+	env = getenv("ENESIM_RENDERER_STATS");
+	if (env && atoi(env))
+		enesim_renderer_stats_enabled = EINA_TRUE;
+#endif
+}
+
+void enesim_renderer_stats_shutdown(void)
+{
+#if BUILD_STATS
+	Enesim_Renderer *r;
+
+	/* the renderers still alive must not touch the list anymore */
+	eina_lock_take(&_renderers_lock);
+	EINA_LIST_FREE(_renderers, r)
+		r->stats.registered = EINA_FALSE;
+	_initialized = EINA_FALSE;
+	eina_lock_release(&_renderers_lock);
+	eina_lock_free(&_renderers_lock);
+	enesim_renderer_stats_enabled = EINA_FALSE;
+#endif
+}
+/*============================================================================*
+ *                                   API                                      *
+ *============================================================================*/
+/**
+ * @brief Enables or disables the recording of the renderers statistics
+ * @param[in] enable EINA_TRUE to start recording, EINA_FALSE to stop
+ *
+ * The statistics are only available when enesim has been configured with
+ * the --enable-stats option. The recording can also be enabled by setting
+ * the ENESIM_RENDERER_STATS environment variable to 1.
+ * @see enesim_renderer_stats_get()
+ */
+EAPI void enesim_renderer_stats_enable_set(Eina_Bool enable)
+{
+#if BUILD_STATS
+	enesim_renderer_stats_enabled = enable;
+#else
+	if (enable)
+		WRN("Statistics support not built in");
+#endif
+}
+
+/**
+ * @brief Checks whether the renderers statistics are being recorded
+ * @return EINA_TRUE if the statistics are being recorded, EINA_FALSE otherwise
+ */
+EAPI Eina_Bool enesim_renderer_stats_enable_get(void)
+{
+#if BUILD_STATS
+	return enesim_renderer_stats_enabled;
+#else
+	return EINA_FALSE;
+#endif
+}
+
+/**
+ * @brief Gets the statistics recorded on a renderer
+ * @param[in] r The renderer to get the statistics from
+ * @param[out] stats The recorded statistics
+ * @return EINA_TRUE if the statistics are available, EINA_FALSE otherwise
+ *
+ * The times are inclusive, i.e the fill time of a renderer that draws other
+ * renderers, like the compound, includes the time spent on those.
+ */
+EAPI Eina_Bool enesim_renderer_stats_get(Enesim_Renderer *r,
+		Enesim_Renderer_Stats *stats)
+{
+	if (!r || !stats) return EINA_FALSE;
+#if BUILD_STATS
+	eina_lock_take(&r->stats.lock);
+	*stats = r->stats.stats;
+	eina_lock_release(&r->stats.lock);
+	return EINA_TRUE;
+#else
+	memset(stats, 0, sizeof(Enesim_Renderer_Stats));
+	return EINA_FALSE;
+#endif
+}
+
+/**
+ * @brief Resets the statistics recorded on a renderer
+ * @param[in] r The renderer to reset the statistics on. In case of NULL
+ * the statistics of every renderer are reset
+ */
+EAPI void enesim_renderer_stats_reset(Enesim_Renderer *r EINA_UNUSED)
+{
+#if BUILD_STATS
+	Eina_List *l;
+
+	if (r)
+	{
+		eina_lock_take(&r->stats.lock);
+		memset(&r->stats.stats, 0, sizeof(Enesim_Renderer_Stats));
+		eina_lock_release(&r->stats.lock);
+		return;
+	}
+
+	eina_lock_take(&_renderers_lock);
+	EINA_LIST_FOREACH(_renderers, l, r)
+	{
+		eina_lock_take(&r->stats.lock);
+		memset(&r->stats.stats, 0, sizeof(Enesim_Renderer_Stats));
+		eina_lock_release(&r->stats.lock);
+	}
+	eina_lock_release(&_renderers_lock);
+#endif
+}
+
+/**
+ * @brief Dumps the statistics recorded on the renderers
+ * @param[in] r The renderer to dump the statistics of. In case of NULL
+ * the statistics of every renderer that has recorded something are dumped
+ * @param[in] f The file to dump the statistics into. In case of NULL the
+ * standard output is used
+ *
+ * Every line is keyed by the name of the renderer as returned by
+ * enesim_renderer_name_get(), the times are in milliseconds
+ */
+EAPI void enesim_renderer_stats_dump(Enesim_Renderer *r EINA_UNUSED,
+		FILE *f EINA_UNUSED)
+{
+#if BUILD_STATS
+	Eina_List *l;
+
+	if (!f) f = stdout;
+	fprintf(f, "%-24s %8s %12s %10s %12s %12s %12s %8s %8s\n",
+			"name", "setups", "setup_ms", "spans", "pixels",
+			"fill_ms", "span_ms", "hits", "misses");
+	if (r)
+	{
+		_stats_dump(r, f);
+		return;
+	}
+
+	eina_lock_take(&_renderers_lock);
+	EINA_LIST_FOREACH(_renderers, l, r)
+		_stats_dump(r, f);
+	eina_lock_release(&_renderers_lock);
+#else
+	WRN("Statistics support not built in");
+#endif
+}
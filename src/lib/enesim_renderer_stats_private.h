@@ -0,0 +1,48 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ENESIM_RENDERER_STATS_PRIVATE_H_
+#define ENESIM_RENDERER_STATS_PRIVATE_H_
+
+#if BUILD_STATS
+/* The instrumentation is compiled in only when configured with
+ * --enable-stats, and even then it is not recorded until it is enabled
+ * with enesim_renderer_stats_enable_set() or the ENESIM_RENDERER_STATS
+ * environment variable. Keep the checks cheap, they are on the span path
+ */
+typedef struct _Enesim_Renderer_Stats_Data
+{
+	Enesim_Renderer_Stats stats;
+	Eina_Lock lock;
+	Eina_Bool registered;
+} Enesim_Renderer_Stats_Data;
+
+extern Eina_Bool enesim_renderer_stats_enabled;
+
+uint64_t enesim_renderer_stats_time_get(void);
+void enesim_renderer_stats_data_init(Enesim_Renderer *r);
+void enesim_renderer_stats_data_shutdown(Enesim_Renderer *r);
+void enesim_renderer_stats_setup_add(Enesim_Renderer *r, uint64_t t);
+void enesim_renderer_stats_fill_add(Enesim_Renderer *r, int len, uint64_t t);
+void enesim_renderer_stats_span_add(Enesim_Renderer *r, uint64_t t);
+void enesim_renderer_stats_cache_add(Enesim_Renderer *r, Eina_Bool hit);
+#endif
+
+void enesim_renderer_stats_init(void);
+void enesim_renderer_stats_shutdown(void);
+
+#endif
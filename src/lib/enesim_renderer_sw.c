@@ -36,6 +36,8 @@
 #include "enesim_object_class.h"
 #include "enesim_object_instance.h"
 
+#include "enesim_color_private.h"
+#include "enesim_buffer_private.h"
 #include "enesim_renderer_private.h"
 #include "enesim_surface_private.h"
 
@@ -48,6 +50,8 @@
  *============================================================================*/
 /** @cond internal */
 #define ENESIM_LOG_DEFAULT enesim_log_renderer
+/* the number of runs to ask a renderer for at once */
+#define ENESIM_RENDERER_SW_RUNS 32
 
 #ifdef BUILD_MULTI_CORE
 static unsigned int _num_cpus;
@@ -93,6 +97,98 @@ static inline void _sw_surface_setup(Enesim_Surface *s, Enesim_Format *dfmt, voi
 	}
 }
 
+/* the fill and compositor calls, in case the statistics are enabled they
+ * get timed. The fill is called on the renderer the fill belongs to, which
+ * is not the same as the drawn one in case the delegation has been collapsed
+ */
+static inline void _sw_fill(Enesim_Renderer *r, Enesim_Renderer_Sw_Data *sw_data,
+		int x, int y, int len, void *dst)
+{
+#if BUILD_STATS
+	if (enesim_renderer_stats_enabled)
+	{
+		uint64_t t;
+
+		t = enesim_renderer_stats_time_get();
+		sw_data->fill(sw_data->fill_r, x, y, len, dst);
+		enesim_renderer_stats_fill_add(r, len,
+				enesim_renderer_stats_time_get() - t);
+		return;
+	}
+#endif
+	sw_data->fill(sw_data->fill_r, x, y, len, dst);
+}
+
+static inline void _sw_span(Enesim_Renderer *r EINA_UNUSED,
+		Enesim_Compositor_Span span,
+		uint32_t *d, uint32_t len, uint32_t *s, Enesim_Color color,
+		uint32_t *m)
+{
+#if BUILD_STATS
+	if (enesim_renderer_stats_enabled)
+	{
+		uint64_t t;
+
+		t = enesim_renderer_stats_time_get();
+		span(d, len, s, color, m);
+		enesim_renderer_stats_span_add(r,
+				enesim_renderer_stats_time_get() - t);
+		return;
+	}
+#endif
+	span(d, len, s, color, m);
+}
+
+/* compose a span using the runs the renderer describes, the solid runs are
+ * drawn directly with their color, the rest are filled and composed. The
+ * color of the runs is the one the fill generates, so it only needs the
+ * color left after the hints
+ */
+static inline void _sw_span_runs_compose(Enesim_Renderer *r,
+		Enesim_Renderer_Sw_Data *sw_data, int x, int y, int len,
+		uint32_t *tmp, uint32_t *data)
+{
+	Enesim_Renderer_Sw_Run runs[ENESIM_RENDERER_SW_RUNS];
+	Enesim_Color color = sw_data->color;
+
+	while (len > 0)
+	{
+		int nruns;
+		int i;
+
+		nruns = sw_data->runs(r, x, y, len, runs, ENESIM_RENDERER_SW_RUNS);
+		if (nruns <= 0)
+		{
+			_sw_fill(r, sw_data, x, y, len, tmp);
+			_sw_span(r, sw_data->span, data, len, tmp, color, NULL);
+			return;
+		}
+		for (i = 0; i < nruns && len > 0; i++)
+		{
+			int rlen = runs[i].len;
+
+			if (rlen <= 0) continue;
+			if (rlen > len) rlen = len;
+			if (runs[i].solid)
+			{
+				Enesim_Color rcolor = runs[i].color;
+
+				if (color != ENESIM_COLOR_FULL)
+					rcolor = enesim_color_mul4_sym(color, rcolor);
+				sw_data->run(data, rlen, rcolor);
+			}
+			else
+			{
+				_sw_fill(r, sw_data, x, y, rlen, tmp);
+				_sw_span(r, sw_data->span, data, rlen, tmp, color, NULL);
+			}
+			x += rlen;
+			data += rlen;
+			len -= rlen;
+		}
+	}
+}
+
 /* worst case, rop+color+mask(rop+color) */
 /* rop+color+mask */
 /* rop+mask */
@@ -102,8 +198,7 @@ static inline void _sw_surface_setup(Enesim_Surface *s, Enesim_Format *dfmt, voi
 /* rop */
 
 static inline void _sw_surface_draw_rop_mask(Enesim_Renderer *r,
-		Enesim_Renderer_Sw_Fill fill,
-		Enesim_Compositor_Span span,
+		Enesim_Renderer_Sw_Data *sw_data,
 		uint8_t *ddata, size_t stride,
 		uint8_t *tmp,
 		uint8_t *tmp_mask,
@@ -111,11 +206,10 @@ static inline void _sw_surface_draw_rop_mask(Enesim_Renderer *r,
 		Eina_Rectangle *area)
 {
 	Enesim_Renderer *mask;
-	Enesim_Color color;
+	Enesim_Color color = sw_data->color;
 
 	/* FIXME do not use this properties, use the generated properties after the _is_sw_draw_composed() */
 	mask = enesim_renderer_mask_get(r);
-	color = enesim_renderer_color_get(r);
 
 	while (area->h--)
 	{
@@ -123,11 +217,11 @@ static inline void _sw_surface_draw_rop_mask(Enesim_Renderer *r,
 		memset(tmp_mask, 0, len);
 		memset(tmp, 0, len);
 
-		fill(r, area->x, area->y, area->w, tmp);
+		_sw_fill(r, sw_data, area->x, area->y, area->w, tmp);
 		enesim_renderer_sw_draw(mask, area->x, area->y, area->w, (uint32_t *)tmp_mask);
 		area->y++;
 		/* compose the filled and the destination spans */
-		span((uint32_t *)ddata, area->w, (uint32_t *)tmp, color, (uint32_t *)tmp_mask);
+		_sw_span(r, sw_data->span, (uint32_t *)ddata, area->w, (uint32_t *)tmp, color, (uint32_t *)tmp_mask);
 		ddata += stride;
 	}
 	enesim_renderer_unref(mask);
@@ -137,24 +231,30 @@ static inline void _sw_surface_draw_rop_mask(Enesim_Renderer *r,
  * color = any (~FLAG_COLORIZE)
  */
 static inline void _sw_surface_draw_rop(Enesim_Renderer *r,
-		Enesim_Renderer_Sw_Fill fill,
-		Enesim_Compositor_Span span,
+		Enesim_Renderer_Sw_Data *sw_data,
 		uint8_t *ddata, size_t stride,
 		uint8_t *tmp, size_t len,
 		Eina_Rectangle *area)
 {
-	Enesim_Color color;
+	Enesim_Color color = sw_data->color;
 
-	/* FIXME do not use the renderer color, use the generated color after the _is_sw_draw_composed() */
-	color = enesim_renderer_color_get(r);
 	while (area->h--)
 	{
-		/* FIXME we should not memset this */
-		memset(tmp, 0, len);
-		fill(r, area->x, area->y, area->w, tmp);
+		if (sw_data->runs)
+		{
+			_sw_span_runs_compose(r, sw_data, area->x, area->y,
+					area->w, (uint32_t *)tmp,
+					(uint32_t *)ddata);
+		}
+		else
+		{
+			/* FIXME we should not memset this */
+			memset(tmp, 0, len);
+			_sw_fill(r, sw_data, area->x, area->y, area->w, tmp);
+			/* compose the filled and the destination spans */
+			_sw_span(r, sw_data->span, (uint32_t *)ddata, area->w, (uint32_t *)tmp, color, NULL);
+		}
 		area->y++;
-		/* compose the filled and the destination spans */
-		span((uint32_t *)ddata, area->w, (uint32_t *)tmp, color, NULL);
 		ddata += stride;
 	}
 }
@@ -164,12 +264,12 @@ static inline void _sw_surface_draw_rop(Enesim_Renderer *r,
  * mask = none
  */
 static inline void _sw_surface_draw_simple(Enesim_Renderer *r,
-		Enesim_Renderer_Sw_Fill fill, uint8_t *ddata,
+		Enesim_Renderer_Sw_Data *sw_data, uint8_t *ddata,
 		size_t stride, Eina_Rectangle *area)
 {
 	while (area->h--)
 	{
-		fill(r, area->x, area->y, area->w, ddata);
+		_sw_fill(r, sw_data, area->x, area->y, area->w, ddata);
 		area->y++;
 		ddata += stride;
 	}
@@ -185,23 +285,44 @@ static inline void _sw_clear(uint8_t *ddata, size_t stride, int bpp,
 		ddata += stride;
 	}
 }
+
+/* draw a span into a scratch row and convert it into the destination buffer
+ * right away, this way the ARGB8888 pixels never leave the cache
+ */
+static inline void _sw_buffer_draw_span(Enesim_Renderer *r,
+		Enesim_Converter_2D cnv, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *ddata, int row, int x, int y, int len,
+		uint32_t *tmp)
+{
+	Enesim_Buffer_Sw_Data sdata;
+	Enesim_Buffer_Sw_Data dat;
+
+	/* the buffer is always filled, even if the renderer draws nothing */
+	if (!enesim_renderer_visibility_get(r))
+		memset(tmp, 0, len * sizeof(uint32_t));
+	else
+		enesim_renderer_sw_draw(r, x, y, len, tmp);
+	sdata.argb8888_pre.plane0 = tmp;
+	sdata.argb8888_pre.plane0_stride = len * sizeof(uint32_t);
+	enesim_buffer_sw_data_at(ddata, dfmt, 0, row, &dat);
+	cnv(&dat, len, 1, &sdata, len, 1);
+}
 /*----------------------------------------------------------------------------*
  *                            Threaded rendering                              *
  *----------------------------------------------------------------------------*/
 #ifdef BUILD_MULTI_CORE
 static inline void _sw_surface_draw_rop_mask_threaded(Enesim_Renderer *r,
 		unsigned int thread,
-		Enesim_Renderer_Sw_Fill fill, Enesim_Compositor_Span span,
+		Enesim_Renderer_Sw_Data *sw_data,
 		uint8_t *ddata, size_t stride,
 		uint8_t *tmp, uint8_t *mtmp, size_t len, Eina_Rectangle *area)
 {
-	Enesim_Color color;
+	Enesim_Color color = sw_data->color;
 	Enesim_Renderer *mask;
 	int h = area->h;
 	int y = area->y;
 
 	/* FIXME do not use this properties, use the generated properties after the _is_sw_draw_composed() */
-	color = enesim_renderer_color_get(r);
 	mask = enesim_renderer_mask_get(r);
 
 	while (h)
@@ -211,10 +332,10 @@ static inline void _sw_surface_draw_rop_mask_threaded(Enesim_Renderer *r,
 		/* FIXME we should not memset this */
 		memset(tmp, 0, len);
 		memset(mtmp, 0, len);
-		fill(r, area->x, y, area->w, tmp);
+		_sw_fill(r, sw_data, area->x, y, area->w, tmp);
 		enesim_renderer_sw_draw(mask, area->x, y, area->w, (uint32_t *)mtmp);
 		/* compose the filled and the destination spans */
-		span((uint32_t *)ddata, area->w, (uint32_t *)tmp, color, (uint32_t *)mtmp);
+		_sw_span(r, sw_data->span, (uint32_t *)ddata, area->w, (uint32_t *)tmp, color, (uint32_t *)mtmp);
 end:
 		ddata += stride;
 		h--;
@@ -225,25 +346,29 @@ end:
 
 static inline void _sw_surface_draw_rop_threaded(Enesim_Renderer *r,
 		unsigned int thread,
-		Enesim_Renderer_Sw_Fill fill, Enesim_Compositor_Span span,
+		Enesim_Renderer_Sw_Data *sw_data,
 		uint8_t *ddata, size_t stride,
 		uint8_t *tmp, size_t len, Eina_Rectangle *area)
 {
-	Enesim_Color color;
+	Enesim_Color color = sw_data->color;
 	int h = area->h;
 	int y = area->y;
 
-	/* FIXME do not use the renderer color, use the generated color after the _is_sw_draw_composed() */
-	color = enesim_renderer_color_get(r);
 	while (h)
 	{
 		if (h % _num_cpus != thread) goto end;
 
+		if (sw_data->runs)
+		{
+			_sw_span_runs_compose(r, sw_data, area->x, y, area->w,
+					(uint32_t *)tmp, (uint32_t *)ddata);
+			goto end;
+		}
 		/* FIXME we should not memset this */
 		memset(tmp, 0, len);
-		fill(r, area->x, y, area->w, tmp);
+		_sw_fill(r, sw_data, area->x, y, area->w, tmp);
 		/* compose the filled and the destination spans */
-		span((uint32_t *)ddata, area->w, (uint32_t *)tmp, color, NULL);
+		_sw_span(r, sw_data->span, (uint32_t *)ddata, area->w, (uint32_t *)tmp, color, NULL);
 end:
 		ddata += stride;
 		h--;
@@ -251,9 +376,25 @@ end:
 	}
 }
 
+static inline void _sw_buffer_draw_threaded(Enesim_Renderer *r,
+		unsigned int thread, Enesim_Converter_2D cnv,
+		Enesim_Buffer_Format dfmt, Enesim_Buffer_Sw_Data *ddata,
+		uint32_t *tmp, Eina_Rectangle *area)
+{
+	int row;
+
+	for (row = 0; row < area->h; row++)
+	{
+		if ((area->h - row) % _num_cpus != thread)
+			continue;
+		_sw_buffer_draw_span(r, cnv, dfmt, ddata, row, area->x,
+				area->y + row, area->w, tmp);
+	}
+}
+
 static inline void _sw_surface_draw_simple_threaded(Enesim_Renderer *r,
 		unsigned int thread,
-		Enesim_Renderer_Sw_Fill fill, uint8_t *ddata,
+		Enesim_Renderer_Sw_Data *sw_data, uint8_t *ddata,
 		size_t stride, Eina_Rectangle *area)
 {
 	int h = area->h;
@@ -263,7 +404,7 @@ static inline void _sw_surface_draw_simple_threaded(Enesim_Renderer *r,
 	{
 		if (h % _num_cpus != thread) goto end;
 
-		fill(r, area->x, y, area->w, ddata);
+		_sw_fill(r, sw_data, area->x, y, area->w, ddata);
 end:
 		ddata += stride;
 		h--;
@@ -271,6 +412,39 @@ end:
 	}
 }
 
+/* make the span buffers of the thread big enough for a span of len bytes.
+ * On failure the buffers are released and the thread does not draw
+ */
+static inline Eina_Bool _sw_thread_buffers_grow(Enesim_Renderer_Thread *thiz,
+		size_t len, Eina_Bool mask)
+{
+	if (thiz->tmp_len < len)
+	{
+		free(thiz->tmp);
+		free(thiz->mtmp);
+		thiz->tmp = malloc(len);
+		thiz->mtmp = NULL;
+		thiz->tmp_len = len;
+		if (!thiz->tmp)
+			goto err;
+	}
+	if (mask && !thiz->mtmp)
+	{
+		thiz->mtmp = malloc(thiz->tmp_len);
+		if (!thiz->mtmp)
+			goto err;
+	}
+	return EINA_TRUE;
+err:
+	ERR("Impossible to allocate the span buffers of thread %d",
+			thiz->cpuidx);
+	free(thiz->tmp);
+	thiz->tmp = NULL;
+	thiz->mtmp = NULL;
+	thiz->tmp_len = 0;
+	return EINA_FALSE;
+}
+
 #ifdef _WIN32
 static DWORD WINAPI _thread_run(void *data)
 #else
@@ -286,62 +460,59 @@ static void * _thread_run(void *data)
 		enesim_barrier_wait(&sw_data->start);
 		if (thiz->done) goto end;
 
-		if (sw_data->span)
+		if (op->cnv)
+		{
+			/* without buffers the lines of this thread are skipped */
+			if (!_sw_thread_buffers_grow(thiz,
+					op->area.w * sizeof(uint32_t),
+					EINA_FALSE))
+				goto next;
+			_sw_buffer_draw_threaded(op->renderer, thiz->cpuidx,
+					op->cnv, op->cfmt, op->cdata,
+					(uint32_t *)thiz->tmp, &op->area);
+		}
+		else if (sw_data->span && !op->direct)
 		{
-			uint8_t *tmp;
 			size_t len;
 
 			len = op->area.w * sizeof(uint32_t);
-			/* FIXME remove this malloc. or we either
-			 * make the tmp buffer part of the renderer
-			 * and make it grow until we reach the span len
-			 * or alloca everytime
-			 */
-			tmp = malloc(len);
+			if (!_sw_thread_buffers_grow(thiz, len,
+					sw_data->use_mask))
+				goto next;
 			if (sw_data->use_mask)
 			{
-				uint8_t *mtmp;
-				/* FIXME remove this malloc. or we either
-				 * make the tmp buffer part of the renderer
-				 * and make it grow until we reach the span len
-				 * or alloca everytime
-				 */
-				mtmp = malloc(len);
 				_sw_surface_draw_rop_mask_threaded(op->renderer,
 						thiz->cpuidx,
-						sw_data->fill,
-						sw_data->span,
+						sw_data,
 						op->dst,
 						op->stride,
-						tmp,
-						mtmp,
+						thiz->tmp,
+						thiz->mtmp,
 						len,
 						&op->area);
-				free(mtmp);
 			}
 			else
 			{
 				_sw_surface_draw_rop_threaded(op->renderer,
 						thiz->cpuidx,
-						sw_data->fill,
-						sw_data->span,
+						sw_data,
 						op->dst,
 						op->stride,
-						tmp,
+						thiz->tmp,
 						len,
 						&op->area);
 			}
-			free(tmp);
 		}
 		else
 		{
 			_sw_surface_draw_simple_threaded(op->renderer,
 					thiz->cpuidx,
-					sw_data->fill,
+					sw_data,
 					op->dst,
 					op->stride,
 					&op->area);
 		}
+next:
 		enesim_barrier_wait(&sw_data->end);
 	} while (1);
 
@@ -355,7 +526,7 @@ end:
 
 static void _sw_draw_threaded(Enesim_Renderer *r, Eina_Rectangle *area,
 		uint8_t *ddata, size_t stride,
-		Enesim_Format dfmt EINA_UNUSED)
+		Enesim_Format dfmt EINA_UNUSED, Eina_Bool direct)
 {
 	Enesim_Renderer_Sw_Data *sw_data;
 	Enesim_Renderer_Thread_Operation *op;
@@ -367,10 +538,58 @@ static void _sw_draw_threaded(Enesim_Renderer *r, Eina_Rectangle *area,
 	op->dst = ddata;
 	op->stride = stride;
 	op->area = *area;
+	op->direct = direct;
+	op->cnv = NULL;
+
+	enesim_barrier_wait(&sw_data->start);
+	enesim_barrier_wait(&sw_data->end);
+}
+
+static void _sw_draw_buffer_threaded(Enesim_Renderer *r, Eina_Rectangle *area,
+		Enesim_Converter_2D cnv, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *ddata)
+{
+	Enesim_Renderer_Sw_Data *sw_data;
+	Enesim_Renderer_Thread_Operation *op;
+
+	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
+	op = &sw_data->op;
+	op->renderer = r;
+	op->area = *area;
+	op->cnv = cnv;
+	op->cfmt = dfmt;
+	op->cdata = ddata;
 
 	enesim_barrier_wait(&sw_data->start);
 	enesim_barrier_wait(&sw_data->end);
 }
+
+static void _sw_threads_setup(Enesim_Renderer *r)
+{
+	Enesim_Renderer_Sw_Data *sw_data;
+	unsigned int i;
+
+	/* create the threads in case those are not created yet */
+	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
+	if (sw_data->threads)
+		return;
+
+	sw_data->threads = malloc(sizeof(Enesim_Renderer_Thread) * _num_cpus);
+
+	enesim_barrier_new(&sw_data->start, _num_cpus + 1);
+	enesim_barrier_new(&sw_data->end, _num_cpus + 1);
+	for (i = 0; i < _num_cpus; i++)
+	{
+		sw_data->threads[i].cpuidx = i;
+		sw_data->threads[i].done = EINA_FALSE;
+		sw_data->threads[i].sw_data = sw_data;
+		sw_data->threads[i].tmp = NULL;
+		sw_data->threads[i].mtmp = NULL;
+		sw_data->threads[i].tmp_len = 0;
+		enesim_thread_new(&sw_data->threads[i].tid, _thread_run, (void *)&sw_data->threads[i]);
+		enesim_thread_affinity_set(sw_data->threads[i].tid, i);
+	}
+}
 #else
 /*----------------------------------------------------------------------------*
  *                          No threaded rendering                             *
@@ -378,12 +597,12 @@ static void _sw_draw_threaded(Enesim_Renderer *r, Eina_Rectangle *area,
 static void _sw_draw_no_threaded(Enesim_Renderer *r,
 		Eina_Rectangle *area,
 		uint8_t *ddata, size_t stride,
-		Enesim_Format dfmt EINA_UNUSED)
+		Enesim_Format dfmt EINA_UNUSED, Eina_Bool direct)
 {
 	Enesim_Renderer_Sw_Data *sw_data;
 
 	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
-	if (sw_data->span)
+	if (sw_data->span && !direct)
 	{
 		uint8_t *fdata;
 		size_t len;
@@ -395,28 +614,131 @@ static void _sw_draw_no_threaded(Enesim_Renderer *r,
 			uint8_t *mdata;
 			mdata = alloca(len);
 
-			_sw_surface_draw_rop_mask(r, sw_data->fill, sw_data->span,
+			_sw_surface_draw_rop_mask(r, sw_data,
 					ddata, stride, fdata, mdata, len, area);
 		}
 		else
 		{
-			_sw_surface_draw_rop(r, sw_data->fill, sw_data->span,
-					ddata, stride, fdata, len, area);
+			_sw_surface_draw_rop(r, sw_data, ddata, stride, fdata,
+					len, area);
 		}
 	}
 	else
 	{
-		_sw_surface_draw_simple(r, sw_data->fill, ddata, stride, area);
+		_sw_surface_draw_simple(r, sw_data, ddata, stride, area);
+	}
+}
+
+static void _sw_draw_buffer_no_threaded(Enesim_Renderer *r,
+		Eina_Rectangle *area, Enesim_Converter_2D cnv,
+		Enesim_Buffer_Format dfmt, Enesim_Buffer_Sw_Data *ddata)
+{
+	uint32_t *tmp;
+	int row;
+
+	tmp = alloca(area->w * sizeof(uint32_t));
+	for (row = 0; row < area->h; row++)
+	{
+		_sw_buffer_draw_span(r, cnv, dfmt, ddata, row, area->x,
+				area->y + row, area->w, tmp);
 	}
 }
 #endif
+
+static void _sw_draw(Enesim_Renderer *r, Eina_Rectangle *area,
+		uint8_t *ddata, size_t stride, Enesim_Format dfmt,
+		Eina_Bool direct)
+{
+#ifdef BUILD_MULTI_CORE
+	_sw_threads_setup(r);
+	_sw_draw_threaded(r, area, ddata, stride, dfmt, direct);
+#else
+	_sw_draw_no_threaded(r, area, ddata, stride, dfmt, direct);
+#endif
+}
+
+static void _sw_draw_buffer(Enesim_Renderer *r, Eina_Rectangle *area,
+		Enesim_Converter_2D cnv, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *ddata)
+{
+#ifdef BUILD_MULTI_CORE
+	_sw_threads_setup(r);
+	_sw_draw_buffer_threaded(r, area, cnv, dfmt, ddata);
+#else
+	_sw_draw_buffer_no_threaded(r, area, cnv, dfmt, ddata);
+#endif
+}
+
+/* Blending a fully opaque source is the same as filling it, so in case
+ * the renderer needs to be composed only because of the blend we can
+ * fill directly into the destination on its opaque area
+ */
+static inline Eina_Bool _sw_opaque_get(Enesim_Renderer *r,
+		Enesim_Renderer_Sw_Data *sw_data, Enesim_Color color,
+		Eina_Rectangle *area, Eina_Rectangle *opaque)
+{
+	if (!sw_data->span || sw_data->use_mask)
+		return EINA_FALSE;
+	if (r->current_rop != ENESIM_ROP_BLEND || color != ENESIM_COLOR_FULL)
+		return EINA_FALSE;
+	if (!eina_rectangle_is_valid(&r->current_opaque_bounds))
+		return EINA_FALSE;
+	*opaque = r->current_opaque_bounds;
+	return eina_rectangle_intersection(opaque, area);
+}
+
+static inline void _sw_span_compose(Enesim_Renderer *r,
+		Enesim_Renderer_Sw_Data *sw_data, int x, int y, int len,
+		uint32_t *data)
+{
+	Enesim_Color color = sw_data->color;
+	uint32_t *tmp;
+	size_t bytes;
+
+	bytes = len * sizeof(uint32_t);
+	tmp = alloca(bytes);
+
+	if (sw_data->runs)
+	{
+		_sw_span_runs_compose(r, sw_data, x, y, len, tmp, data);
+		return;
+	}
+	/* We dont need to zero the buffer given that a fill will
+	 * draw every pixel in case the span is inside the bounds
+	 */
+	_sw_fill(r, sw_data, x, y, len, tmp);
+	/* compose the filled and the destination spans */
+	if (sw_data->use_mask)
+	{
+		uint32_t *mtmp;
+
+		/* We assume it is 32bpp mask, later we can use the a8 variant */
+		mtmp = alloca(bytes);
+		enesim_renderer_sw_draw(r->state.current.mask, x, y, len, mtmp);
+		_sw_span(r, sw_data->span, data, len, tmp, color, mtmp);
+	}
+	else
+	{
+		_sw_span(r, sw_data->span, data, len, tmp, color, NULL);
+	}
+}
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
 void enesim_renderer_sw_init(void)
 {
 #ifdef BUILD_MULTI_CORE
+	const char *env;
+
 	_num_cpus = eina_cpu_count();
+	/* allow to limit the number of threads, useful for benchmarking */
+	env = getenv("ENESIM_CPU_COUNT");
+	if (env)
+	{
+		int count = atoi(env);
+		if (count > 0 && (unsigned int)count < _num_cpus)
+			_num_cpus = count;
+	}
 #endif
 }
 
@@ -450,9 +772,8 @@ void enesim_renderer_sw_draw_area(Enesim_Renderer *r, Enesim_Surface *s,
 	uint8_t *ddata;
 	size_t stride;
 	size_t bpp;
-#ifdef BUILD_MULTI_CORE
 	Enesim_Renderer_Sw_Data *sw_data;
-#endif
+	Eina_Rectangle opaque;
 
 	/* TODO in case of a mask, first intersect the mask bounds with the
 	 * renderer bounds, if they do not intersect return
@@ -524,30 +845,49 @@ void enesim_renderer_sw_draw_area(Enesim_Renderer *r, Enesim_Surface *s,
 	 */
 	final.x -= x;
 	final.y -= y;
-#ifdef BUILD_MULTI_CORE
-	/* create the threads in case those are not created yet */
+
+	/* draw the opaque area directly, the rest composed */
 	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
-	if (!sw_data->threads)
+	if (dfmt == ENESIM_FORMAT_ARGB8888 &&
+			_sw_opaque_get(r, sw_data, color, &final, &opaque))
 	{
-		unsigned int i;
+		Eina_Rectangle subs[4];
+		int i;
 
-		sw_data->threads = malloc(sizeof(Enesim_Renderer_Thread) * _num_cpus);
-
-		enesim_barrier_new(&sw_data->start, _num_cpus + 1);
-		enesim_barrier_new(&sw_data->end, _num_cpus + 1);
-		for (i = 0; i < _num_cpus; i++)
+		eina_rectangle_subtract(&final, &opaque, subs);
+		for (i = 0; i < 4; i++)
 		{
-			sw_data->threads[i].cpuidx = i;
-			sw_data->threads[i].done = EINA_FALSE;
-			sw_data->threads[i].sw_data = sw_data;
-			enesim_thread_new(&sw_data->threads[i].tid, _thread_run, (void *)&sw_data->threads[i]);
-			enesim_thread_affinity_set(sw_data->threads[i].tid, i);
+			if (!eina_rectangle_is_valid(&subs[i]))
+				continue;
+			_sw_draw(r, &subs[i], ddata + ((subs[i].y - final.y) * stride) +
+					((subs[i].x - final.x) * bpp), stride, dfmt,
+					EINA_FALSE);
 		}
+		_sw_draw(r, &opaque, ddata + ((opaque.y - final.y) * stride) +
+				((opaque.x - final.x) * bpp), stride, dfmt, EINA_TRUE);
+	}
+	else
+	{
+		_sw_draw(r, &final, ddata, stride, dfmt, EINA_FALSE);
 	}
-	_sw_draw_threaded(r, &final, ddata, stride, dfmt);
-#else
-	_sw_draw_no_threaded(r, &final, ddata, stride, dfmt);
-#endif
+}
+
+/* The renderer must be setup with the fill rop on an ARGB8888 surface, every
+ * span of the area is drawn and then converted into the buffer
+ */
+void enesim_renderer_sw_draw_buffer_area(Enesim_Renderer *r,
+		Enesim_Converter_2D cnv, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *ddata, Eina_Rectangle *area, int x, int y)
+{
+	Enesim_Buffer_Sw_Data dat;
+	Eina_Rectangle final;
+
+	enesim_buffer_sw_data_at(ddata, dfmt, area->x, area->y, &dat);
+	/* the spans are drawn on the renderer coordinate space */
+	final = *area;
+	final.x -= x;
+	final.y -= y;
+	_sw_draw_buffer(r, &final, cnv, dfmt, &dat);
 }
 
 Eina_Bool enesim_renderer_sw_setup(Enesim_Renderer *r,
@@ -556,6 +896,8 @@ Eina_Bool enesim_renderer_sw_setup(Enesim_Renderer *r,
 	Enesim_Renderer_Class *klass;
 	Enesim_Renderer_Sw_Fill fill = NULL;
 	Enesim_Compositor_Span span = NULL;
+	Enesim_Compositor_Run run = NULL;
+	Enesim_Renderer_Sw_Runs_Get runs = NULL;
 	Enesim_Renderer_Sw_Data *sw_data;
 	Enesim_Renderer_Sw_Hint hints;
 	Enesim_Renderer *mask;
@@ -567,6 +909,15 @@ Eina_Bool enesim_renderer_sw_setup(Enesim_Renderer *r,
 	if (!klass->sw_setup)
 		return EINA_FALSE;
 
+	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
+	if (!sw_data)
+	{
+		sw_data = calloc(1, sizeof(Enesim_Renderer_Sw_Data));
+		enesim_renderer_backend_data_set(r, ENESIM_BACKEND_SOFTWARE, sw_data);
+	}
+	/* the setup sets it again in case the renderer delegates */
+	sw_data->delegate = NULL;
+
 	if (!klass->sw_setup(r, s, rop, &fill, error))
 	{
 		WRN("Setup callback on '%s' failed", r->name);
@@ -595,13 +946,6 @@ Eina_Bool enesim_renderer_sw_setup(Enesim_Renderer *r,
 		}
 	}
 
-	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
-	if (!sw_data)
-	{
-		sw_data = calloc(1, sizeof(Enesim_Renderer_Sw_Data));
-		enesim_renderer_backend_data_set(r, ENESIM_BACKEND_SOFTWARE, sw_data);
-	}
-
 	color = enesim_renderer_color_get(r);
 	enesim_renderer_sw_hints_get(r, rop, &hints);
 
@@ -628,17 +972,83 @@ Eina_Bool enesim_renderer_sw_setup(Enesim_Renderer *r,
 			enesim_renderer_unref(mask);
 			return EINA_FALSE;
 		}
+		/* the solid runs can be composed directly, but only without
+		 * a mask
+		 */
+		if (klass->sw_runs_get && !use_mask)
+		{
+			run = enesim_compositor_run_get(rop, &dfmt);
+			if (run)
+				runs = klass->sw_runs_get;
+		}
 	}
 
 	/* TODO add a real_draw function that will compose the two ... or not :) */
 	sw_data->span = span;
+	sw_data->color = color;
 	sw_data->fill = fill;
+	sw_data->fill_r = r;
+	sw_data->runs = runs;
+	sw_data->run = run;
 	sw_data->use_mask = use_mask;
 	enesim_renderer_unref(mask);
 
 	return EINA_TRUE;
 }
 
+/* To be called from the setup of a renderer whose fill only draws another
+ * renderer that has already been setup
+ */
+void enesim_renderer_sw_delegate_set(Enesim_Renderer *r,
+		Enesim_Renderer *delegate)
+{
+	Enesim_Renderer_Sw_Data *sw_data;
+
+	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
+	sw_data->delegate = delegate;
+}
+
+/* In case the delegate fills directly and every span of the renderer is
+ * inside its bounds, drawing the delegate is the same as calling its fill.
+ * Use it as our own fill to skip the bounds, color and mask checks of every
+ * level of the delegation on every span. The delegate has already been
+ * collapsed, so the fill is the one of the last renderer of the chain
+ */
+void enesim_renderer_sw_delegate_collapse(Enesim_Renderer *r)
+{
+	Enesim_Renderer_Sw_Data *sw_data;
+	Enesim_Renderer_Sw_Data *dsw_data;
+	Enesim_Renderer *d;
+	Eina_Rectangle bounds;
+
+	sw_data = enesim_renderer_backend_data_get(r, ENESIM_BACKEND_SOFTWARE);
+	if (!sw_data || !sw_data->delegate)
+		return;
+
+	d = sw_data->delegate;
+	dsw_data = enesim_renderer_backend_data_get(d, ENESIM_BACKEND_SOFTWARE);
+	if (!dsw_data || dsw_data->span || dsw_data->use_mask)
+		return;
+	if (!enesim_renderer_visibility_get(d) || !enesim_renderer_color_get(d))
+		return;
+	if (d->current_rop != r->current_rop)
+		return;
+
+	bounds = d->current_destination_bounds;
+	if (!eina_rectangle_intersection(&bounds, &r->current_destination_bounds))
+		return;
+	if (bounds.x != r->current_destination_bounds.x ||
+			bounds.y != r->current_destination_bounds.y ||
+			bounds.w != r->current_destination_bounds.w ||
+			bounds.h != r->current_destination_bounds.h)
+		return;
+
+	DBG("Collapsing the delegation of '%s' into '%s'", r->name,
+			dsw_data->fill_r->name);
+	sw_data->fill = dsw_data->fill;
+	sw_data->fill_r = dsw_data->fill_r;
+}
+
 void enesim_renderer_sw_cleanup(Enesim_Renderer *r, Enesim_Surface *s)
 {
 	Enesim_Renderer *mask;
@@ -679,7 +1089,11 @@ void enesim_renderer_sw_free(Enesim_Renderer *r)
 		enesim_barrier_wait(&sw_data->start);
 		/* destroy the threads */
 		for (i = 0; i < _num_cpus; i++)
+		{
 			enesim_thread_free(sw_data->threads[i].tid);
+			free(sw_data->threads[i].tmp);
+			free(sw_data->threads[i].mtmp);
+		}
 		free(sw_data->threads);
 		enesim_barrier_free(&sw_data->start);
 		enesim_barrier_free(&sw_data->end);
@@ -695,6 +1109,7 @@ void enesim_renderer_sw_draw(Enesim_Renderer *r,  int x, int y,
 	Enesim_Color color;
 	Eina_Rectangle span;
 	Eina_Rectangle rbounds, mbounds;
+	Eina_Rectangle opaque;
 	Eina_Bool visible;
 	unsigned int left;
 
@@ -758,36 +1173,29 @@ mask_done:
 			EINA_RECTANGLE_FORMAT, EINA_RECTANGLE_ARGS (&span),
 			r->name,  EINA_RECTANGLE_ARGS (&rbounds));
 
-	if (sw_data->span)
+	if (_sw_opaque_get(r, sw_data, color, &rbounds, &opaque))
 	{
-		uint32_t *tmp;
-		size_t bytes;
-
-		bytes = rbounds.w * sizeof(uint32_t);
-		tmp = alloca(bytes);
-
-		/* We dont need to zero the buffer given that a fill will
-		 * draw every pixel in case the span is inside the bounds
-		 */
-		sw_data->fill(r, rbounds.x, rbounds.y, rbounds.w, tmp);
-		/* compose the filled and the destination spans */
-		if (sw_data->use_mask)
-		{
-			uint32_t *mtmp;
-
-			/* We assume it is 32bpp mask, later we can use the a8 variant */
-			mtmp = alloca(bytes);
-			enesim_renderer_sw_draw(r->state.current.mask, rbounds.x, rbounds.y, rbounds.w, mtmp);
-			sw_data->span(data + left, rbounds.w, tmp, color, mtmp);
-		}
-		else
-		{
-			sw_data->span(data + left, rbounds.w, tmp, color, NULL);
-		}
+		int end = rbounds.x + rbounds.w;
+		int oend = opaque.x + opaque.w;
+
+		/* compose the sides and fill directly the opaque area */
+		if (opaque.x > rbounds.x)
+			_sw_span_compose(r, sw_data, rbounds.x, rbounds.y,
+					opaque.x - rbounds.x, data + left);
+		_sw_fill(r, sw_data, opaque.x, opaque.y, opaque.w,
+				data + (opaque.x - span.x));
+		if (end > oend)
+			_sw_span_compose(r, sw_data, oend, rbounds.y,
+					end - oend, data + (oend - span.x));
+	}
+	else if (sw_data->span)
+	{
+		_sw_span_compose(r, sw_data, rbounds.x, rbounds.y, rbounds.w,
+				data + left);
 	}
 	else
 	{
-		sw_data->fill(r, rbounds.x, rbounds.y, rbounds.w, data + left);
+		_sw_fill(r, sw_data, rbounds.x, rbounds.y, rbounds.w, data + left);
 	}
 
 	if (r->current_rop == ENESIM_ROP_FILL)
@@ -20,6 +20,7 @@
 
 #include "enesim_thread_private.h"
 #include "enesim_barrier_private.h"
+#include "enesim_converter_private.h"
 
 /**
  * The fill function that every software based renderer should implement
@@ -35,6 +36,33 @@ typedef void (*Enesim_Renderer_Sw_Fill)(Enesim_Renderer *r,
 		int x, int y, int len, void *dst);
 typedef struct _Enesim_Renderer_Sw_Data Enesim_Renderer_Sw_Data;
 
+/**
+ * A run of consecutive pixels of a span
+ */
+typedef struct _Enesim_Renderer_Sw_Run
+{
+	int len; /**< The number of pixels of the run */
+	Enesim_Color color; /**< The color of every pixel in case of a solid run */
+	Eina_Bool solid; /**< In case every pixel of the run has the same color */
+} Enesim_Renderer_Sw_Run;
+
+/**
+ * The optional function a software based renderer can implement to describe
+ * the runs of pixels a span is made of. The solid runs are composed directly
+ * with their color and the rest are filled as usual
+ * @param r The renderer to describe
+ * @param x The x coordinate of the span
+ * @param y The y coordinate of the span
+ * @param len The length of the span
+ * @param runs The runs to describe
+ * @param max The maximum number of runs to describe
+ * @return The number of runs described. The runs start at x but do not need
+ * to cover the whole span, in that case the function is called again for the
+ * rest of it. Zero in case the span must be filled as usual
+ */
+typedef int (*Enesim_Renderer_Sw_Runs_Get)(Enesim_Renderer *r,
+		int x, int y, int len, Enesim_Renderer_Sw_Run *runs, int max);
+
 #if BUILD_THREAD
 typedef struct _Enesim_Renderer_Thread_Operation
 {
@@ -43,6 +71,12 @@ typedef struct _Enesim_Renderer_Thread_Operation
 	uint8_t * dst;
 	size_t stride;
 	Eina_Rectangle area;
+	/* fill directly without composing */
+	Eina_Bool direct;
+	/* convert every span into a buffer instead of drawing into dst */
+	Enesim_Converter_2D cnv;
+	Enesim_Buffer_Format cfmt;
+	Enesim_Buffer_Sw_Data *cdata;
 } Enesim_Renderer_Thread_Operation;
 
 typedef struct _Enesim_Renderer_Thread
@@ -51,6 +85,10 @@ typedef struct _Enesim_Renderer_Thread
 	Enesim_Thread tid;
 	Eina_Bool done;
 	Enesim_Renderer_Sw_Data *sw_data;
+	/* the span buffers of the thread, they only grow */
+	uint8_t *tmp;
+	uint8_t *mtmp;
+	size_t tmp_len;
 } Enesim_Renderer_Thread;
 #endif
 
@@ -74,7 +112,16 @@ struct _Enesim_Renderer_Sw_Data
 	 *  the fill only or both, to avoid the if
 	 */
 	Enesim_Renderer_Sw_Fill fill;
+	/* the renderer to call the fill on */
+	Enesim_Renderer *fill_r;
+	/* the renderer every span is delegated to */
+	Enesim_Renderer *delegate;
 	Enesim_Compositor_Span span;
+	/* the color to compose with, once the hints have been applied */
+	Enesim_Color color;
+	/* in case the renderer can describe the runs of a span */
+	Enesim_Renderer_Sw_Runs_Get runs;
+	Enesim_Compositor_Run run;
 	Eina_Bool use_mask;
 };
 
@@ -84,7 +131,13 @@ void enesim_renderer_sw_init(void);
 void enesim_renderer_sw_shutdown(void);
 void enesim_renderer_sw_draw_area(Enesim_Renderer *r, Enesim_Surface *s,
 		Enesim_Rop rop, Eina_Rectangle *area, int x, int y);
+void enesim_renderer_sw_draw_buffer_area(Enesim_Renderer *r,
+		Enesim_Converter_2D cnv, Enesim_Buffer_Format dfmt,
+		Enesim_Buffer_Sw_Data *ddata, Eina_Rectangle *area, int x, int y);
 void enesim_renderer_sw_free(Enesim_Renderer *r);
+void enesim_renderer_sw_delegate_set(Enesim_Renderer *r,
+		Enesim_Renderer *delegate);
+void enesim_renderer_sw_delegate_collapse(Enesim_Renderer *r);
 
 Eina_Bool enesim_renderer_sw_setup(Enesim_Renderer *r, Enesim_Surface *s, Enesim_Rop rop, Enesim_Log **error);
 void enesim_renderer_sw_cleanup(Enesim_Renderer *r, Enesim_Surface *s);
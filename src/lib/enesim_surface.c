@@ -623,3 +623,24 @@ EAPI Eina_Bool enesim_surface_convert_list(Enesim_Surface *thiz, Enesim_Buffer *
 	enesim_buffer_unref(src);
 	return ret;
 }
+
+/**
+ * Converts a surface into a buffer dithering the components
+ * @param[in] thiz The surface to convert
+ * @param[in] dst The destination buffer
+ * @param[in] clips A list of clipping areas on the destination surface to limit the conversion. @ender_nullable
+ * @param[in] dither The dithering mode to use
+ * @return EINA_TRUE if the conversion was correct, EINA_FALSE otherwise
+ * @see enesim_buffer_convert_dithered()
+ */
+EAPI Eina_Bool enesim_surface_convert_dithered(Enesim_Surface *thiz,
+		Enesim_Buffer *dst, Eina_List *clips, Enesim_Buffer_Dither dither)
+{
+	Enesim_Buffer *src;
+	Eina_Bool ret;
+
+	src = enesim_surface_buffer_get(thiz);
+	ret = enesim_buffer_convert_dithered(src, dst, clips, dither);
+	enesim_buffer_unref(src);
+	return ret;
+}
@@ -81,6 +81,8 @@ EAPI Enesim_Alpha_Hint enesim_surface_alpha_hint_get(Enesim_Surface *s);
 EAPI Eina_Bool enesim_surface_convert(Enesim_Surface *thiz, Enesim_Buffer *dst);
 EAPI Eina_Bool enesim_surface_convert_list(Enesim_Surface *thiz, Enesim_Buffer *dst,
 		Eina_List *clips);
+EAPI Eina_Bool enesim_surface_convert_dithered(Enesim_Surface *thiz,
+		Enesim_Buffer *dst, Eina_List *clips, Enesim_Buffer_Dither dither);
 
 /** @} */ //End of Enesim_Surface
 
@@ -65,6 +65,14 @@ EAPI Enesim_Text_Engine * enesim_text_engine_ref(Enesim_Text_Engine *thiz);
 EAPI void enesim_text_engine_unref(Enesim_Text_Engine *thiz);
 EAPI Eina_Bool enesim_text_engine_type_get(Enesim_Text_Engine *thiz,
 		const char **lib, const char **name);
+EAPI void enesim_text_engine_glyph_cache_size_set(Enesim_Text_Engine *thiz,
+		size_t size);
+EAPI size_t enesim_text_engine_glyph_cache_size_get(Enesim_Text_Engine *thiz);
+EAPI void enesim_text_engine_glyph_cache_timeout_set(Enesim_Text_Engine *thiz,
+		unsigned int timeout);
+EAPI unsigned int enesim_text_engine_glyph_cache_timeout_get(
+		Enesim_Text_Engine *thiz);
+EAPI void enesim_text_engine_glyph_cache_flush(Enesim_Text_Engine *thiz);
 /**
  * @}
  * @defgroup Enesim_Text_Engine_Freetype FreeType Text Engine
@@ -91,6 +99,10 @@ EAPI Enesim_Text_Font * enesim_text_font_ref(Enesim_Text_Font *thiz);
 EAPI void enesim_text_font_unref(Enesim_Text_Font *thiz);
 EAPI int enesim_text_font_max_ascent_get(Enesim_Text_Font *thiz);
 EAPI int enesim_text_font_max_descent_get(Enesim_Text_Font *thiz);
+EAPI void enesim_text_font_glyphs_budget_set(Enesim_Text_Font *thiz,
+		size_t budget);
+EAPI size_t enesim_text_font_glyphs_budget_get(Enesim_Text_Font *thiz);
+EAPI size_t enesim_text_font_glyphs_memory_get(Enesim_Text_Font *thiz);
 
 /**
  * @}
@@ -147,6 +159,8 @@ EAPI void enesim_text_buffer_smart_real_set(Enesim_Text_Buffer *b,
 EAPI void enesim_text_buffer_smart_dirty(Enesim_Text_Buffer *b);
 EAPI void enesim_text_buffer_smart_clear(Enesim_Text_Buffer *b);
 EAPI Eina_Bool enesim_text_buffer_smart_is_dirty(Enesim_Text_Buffer *b);
+EAPI Eina_Bool enesim_text_buffer_smart_dirty_range_get(Enesim_Text_Buffer *b,
+		int *start, int *end, int *delta);
 
 /**
  * @}
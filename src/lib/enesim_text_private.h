@@ -76,10 +76,13 @@ void enesim_text_engine_freetype_lock(Enesim_Text_Engine *e);
 void enesim_text_engine_freetype_unlock(Enesim_Text_Engine *e);
 FT_Library enesim_text_engine_freetype_lib_get(Enesim_Text_Engine *e);
 
-Enesim_Text_Font * enesim_text_font_freetype_new(FT_Face face);
+Enesim_Text_Font * enesim_text_font_freetype_new(FT_Face face,
+		const char *file, int index, int size);
 FT_Face enesim_text_font_freetype_face_get(Enesim_Text_Font *f);
 
 Enesim_Text_Glyph * enesim_text_glyph_freetype_new(FT_UInt index);
+void enesim_text_glyph_freetype_load_from(Enesim_Text_Glyph *g,
+		FT_Library lib, FT_Face face, int formats);
 #endif
 
 #endif
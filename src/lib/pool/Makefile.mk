@@ -1,7 +1,9 @@
 
 src_lib_libenesim_la_SOURCES += \
 src/lib/pool/enesim_pool_sw.c \
-src/lib/pool/enesim_pool_eina.c
+src/lib/pool/enesim_pool_eina.c \
+src/lib/pool/enesim_pool_recycle.c \
+src/lib/pool/enesim_pool_mmap.c
 
 if HAVE_OPENCL
 src_lib_libenesim_la_SOURCES += src/lib/pool/enesim_pool_opencl.c
@@ -0,0 +1,338 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_private.h"
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include "enesim_main.h"
+#include "enesim_pool.h"
+#include "enesim_buffer.h"
+
+#include "enesim_pool_private.h"
+#include "enesim_buffer_private.h"
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+/** @cond internal */
+#define ENESIM_LOG_DEFAULT enesim_log_pool
+
+/* the size of a transparent huge page */
+#define ENESIM_POOL_MMAP_HUGE_SIZE (2 * 1024 * 1024)
+/* the number of released mappings kept for the next buffers */
+#define ENESIM_POOL_MMAP_CACHED 2
+
+#if defined(HAVE_SYS_MMAN_H) && defined(MAP_ANONYMOUS)
+#define ENESIM_POOL_MMAP 1
+#else
+#define ENESIM_POOL_MMAP 0
+#endif
+
+typedef struct _Enesim_Pool_Mmap_Region
+{
+	void *map;
+	size_t size;
+} Enesim_Pool_Mmap_Region;
+
+/* the backend data of every buffer, the sw data must be the first member */
+typedef struct _Enesim_Pool_Mmap_Data
+{
+	Enesim_Buffer_Sw_Data sw_data;
+	Enesim_Pool_Mmap_Region region;
+} Enesim_Pool_Mmap_Data;
+
+typedef struct _Enesim_Pool_Mmap
+{
+	size_t threshold;
+	/* the released mappings, already advised to drop their pages */
+	Eina_List *cached;
+	Eina_Lock lock;
+} Enesim_Pool_Mmap;
+
+#if ENESIM_POOL_MMAP
+/* map an anonymous region aligned to a huge page so the kernel can back
+ * it with huge pages. The pages are zeroed by the kernel on first touch
+ */
+static Eina_Bool _region_map(Enesim_Pool_Mmap_Region *r, size_t size)
+{
+	uint8_t *map;
+	uint8_t *start;
+	size_t head;
+	size_t tail;
+
+	map = mmap(NULL, size + ENESIM_POOL_MMAP_HUGE_SIZE,
+			PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+			-1, 0);
+	if (map == MAP_FAILED)
+		return EINA_FALSE;
+	start = (uint8_t *)(((uintptr_t)map + ENESIM_POOL_MMAP_HUGE_SIZE - 1) &
+			~((uintptr_t)ENESIM_POOL_MMAP_HUGE_SIZE - 1));
+	head = start - map;
+	tail = ENESIM_POOL_MMAP_HUGE_SIZE - head;
+	if (head)
+		munmap(map, head);
+	if (tail)
+		munmap(start + size, tail);
+#ifdef MADV_HUGEPAGE
+	madvise(start, size, MADV_HUGEPAGE);
+#endif
+	r->map = start;
+	r->size = size;
+	return EINA_TRUE;
+}
+
+static void _region_unmap(Enesim_Pool_Mmap_Region *r)
+{
+	munmap(r->map, r->size);
+}
+
+static Eina_Bool _region_get(Enesim_Pool_Mmap *thiz,
+		Enesim_Pool_Mmap_Region *r, size_t bytes)
+{
+	Enesim_Pool_Mmap_Region *cached;
+	Eina_List *l;
+	size_t size;
+
+	size = (bytes + ENESIM_POOL_MMAP_HUGE_SIZE - 1) &
+			~((size_t)ENESIM_POOL_MMAP_HUGE_SIZE - 1);
+	eina_lock_take(&thiz->lock);
+	EINA_LIST_FOREACH(thiz->cached, l, cached)
+	{
+		if (cached->size != size)
+			continue;
+		*r = *cached;
+		thiz->cached = eina_list_remove_list(thiz->cached, l);
+		eina_lock_release(&thiz->lock);
+		free(cached);
+		return EINA_TRUE;
+	}
+	eina_lock_release(&thiz->lock);
+	return _region_map(r, size);
+}
+
+/* keep the mapping but give the pages back to the system, the next use
+ * of the mapping gets zeroed pages lazily
+ */
+static void _region_put(Enesim_Pool_Mmap *thiz, Enesim_Pool_Mmap_Region *r)
+{
+	Enesim_Pool_Mmap_Region *cached;
+
+	eina_lock_take(&thiz->lock);
+	if (eina_list_count(thiz->cached) >= ENESIM_POOL_MMAP_CACHED)
+	{
+		eina_lock_release(&thiz->lock);
+		_region_unmap(r);
+		return;
+	}
+	madvise(r->map, r->size, MADV_DONTNEED);
+	cached = malloc(sizeof(Enesim_Pool_Mmap_Region));
+	*cached = *r;
+	thiz->cached = eina_list_append(thiz->cached, cached);
+	eina_lock_release(&thiz->lock);
+}
+#endif
+
+static Eina_Bool _data_map(Enesim_Pool_Mmap *thiz, Enesim_Pool_Mmap_Data *data,
+		Enesim_Buffer_Format fmt, size_t stride, size_t bytes)
+{
+#if ENESIM_POOL_MMAP
+	if (!_region_get(thiz, &data->region, bytes))
+	{
+		ERR("Impossible to map %zu bytes", bytes);
+		return EINA_FALSE;
+	}
+	if (!enesim_buffer_sw_data_set(&data->sw_data, fmt, data->region.map,
+			stride))
+	{
+		_region_put(thiz, &data->region);
+		return EINA_FALSE;
+	}
+	return EINA_TRUE;
+#else
+	return EINA_FALSE;
+#endif
+}
+
+static void _data_free_cb(void *data, void *user_data EINA_UNUSED)
+{
+	enesim_buffer_sw_aligned_free(data, NULL);
+}
+/*----------------------------------------------------------------------------*
+ *                        The Enesim's pool interface                         *
+ *----------------------------------------------------------------------------*/
+static const char * _type_get(void)
+{
+	return "enesim.pool.mmap";
+}
+
+static Eina_Bool _data_alloc(void *prv,
+		Enesim_Backend *backend,
+		void **backend_data,
+		Enesim_Buffer_Format fmt, uint32_t w, uint32_t h)
+{
+	Enesim_Pool_Mmap *thiz = prv;
+	Enesim_Pool_Mmap_Data *data;
+	size_t bytes;
+	size_t stride;
+
+	stride = enesim_buffer_sw_aligned_stride_get(fmt, w);
+	bytes = stride * h;
+
+	data = calloc(1, sizeof(Enesim_Pool_Mmap_Data));
+	if (ENESIM_POOL_MMAP && bytes >= thiz->threshold)
+	{
+		if (!_data_map(thiz, data, fmt, stride, bytes))
+		{
+			free(data);
+			return EINA_FALSE;
+		}
+	}
+	else
+	{
+		if (!enesim_buffer_sw_data_aligned_alloc(&data->sw_data, fmt, w, h))
+		{
+			free(data);
+			return EINA_FALSE;
+		}
+	}
+	*backend = ENESIM_BACKEND_SOFTWARE;
+	*backend_data = data;
+	return EINA_TRUE;
+}
+
+static Eina_Bool _data_from(void *prv EINA_UNUSED,
+		Enesim_Backend *backend,
+		void **backend_data,
+		Enesim_Buffer_Format fmt EINA_UNUSED,
+		uint32_t w EINA_UNUSED, uint32_t h EINA_UNUSED,
+		Eina_Bool copy,
+		Enesim_Buffer_Sw_Data *src)
+{
+	Enesim_Pool_Mmap_Data *data;
+
+	if (copy)
+	{
+		ERR("Can't copy data TODO");
+		return EINA_FALSE;
+	}
+	*backend = ENESIM_BACKEND_SOFTWARE;
+	data = calloc(1, sizeof(Enesim_Pool_Mmap_Data));
+	*backend_data = data;
+	data->sw_data = *src;
+
+	return EINA_TRUE;
+}
+
+static void _data_free(void *prv,
+		void *backend_data,
+		Enesim_Buffer_Format fmt,
+		Eina_Bool external_allocated)
+{
+	Enesim_Pool_Mmap *thiz = prv;
+	Enesim_Pool_Mmap_Data *data = backend_data;
+
+	if (!external_allocated)
+	{
+#if ENESIM_POOL_MMAP
+		if (data->region.map)
+			_region_put(thiz, &data->region);
+		else
+#endif
+			enesim_buffer_sw_data_free(&data->sw_data, fmt,
+					_data_free_cb, thiz);
+	}
+	free(data);
+}
+
+static Eina_Bool _data_get(void *prv EINA_UNUSED,
+		void *backend_data,
+		Enesim_Buffer_Format fmt EINA_UNUSED,
+		uint32_t w EINA_UNUSED, uint32_t h EINA_UNUSED,
+		Enesim_Buffer_Sw_Data *dst)
+{
+	Enesim_Pool_Mmap_Data *data = backend_data;
+
+	*dst = data->sw_data;
+
+	return EINA_TRUE;
+}
+
+static void _free(void *prv)
+{
+	Enesim_Pool_Mmap *thiz = prv;
+	Enesim_Pool_Mmap_Region *r;
+
+	EINA_LIST_FREE(thiz->cached, r)
+	{
+#if ENESIM_POOL_MMAP
+		_region_unmap(r);
+#endif
+		free(r);
+	}
+	eina_lock_free(&thiz->lock);
+	free(thiz);
+}
+
+static Enesim_Pool_Descriptor _descriptor = {
+	/* .type_get =   */ _type_get,
+	/* .data_alloc = */ _data_alloc,
+	/* .data_free =  */ _data_free,
+	/* .data_from =  */ _data_from,
+	/* .data_get =   */ _data_get,
+	/* .data_put =   */ NULL,
+	/* .free =       */ _free,
+};
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+/** @endcond */
+/*============================================================================*
+ *                                   API                                      *
+ *============================================================================*/
+/**
+ * @brief Create a software pool that maps the memory of the big buffers
+ * @param[in] threshold The number of bytes from which a buffer is mapped
+ * @return The newly allocated pool
+ *
+ * The buffers of at least @p threshold bytes are allocated on anonymous
+ * memory mappings advised to use transparent huge pages, which reduces the
+ * TLB misses when walking very big surfaces. The pages are zeroed lazily by
+ * the system on first touch and given back to it as soon as the buffer is
+ * freed. Smaller buffers are allocated as in the sw pool. In case the
+ * system has no memory mappings every buffer is allocated as in the sw pool.
+ */
+EAPI Enesim_Pool * enesim_pool_mmap_new(size_t threshold)
+{
+	Enesim_Pool_Mmap *thiz;
+	Enesim_Pool *p;
+
+	thiz = calloc(1, sizeof(Enesim_Pool_Mmap));
+	thiz->threshold = threshold;
+	eina_lock_new(&thiz->lock);
+
+	p = enesim_pool_new(&_descriptor, thiz);
+	if (!p)
+	{
+		eina_lock_free(&thiz->lock);
+		free(thiz);
+		return NULL;
+	}
+
+	return p;
+}
@@ -0,0 +1,388 @@
+/* ENESIM - Drawing Library
+ * Copyright (C) 2007-2013 Jorge Luis Zapata
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "enesim_private.h"
+
+#include "enesim_main.h"
+#include "enesim_pool.h"
+#include "enesim_buffer.h"
+
+#include "enesim_pool_private.h"
+#include "enesim_buffer_private.h"
+/*============================================================================*
+ *                                  Local                                     *
+ *============================================================================*/
+/** @cond internal */
+#define ENESIM_LOG_DEFAULT enesim_log_pool
+
+/* every power of two is split on this number of size classes */
+#define ENESIM_POOL_RECYCLE_CLASS_STEPS 4
+#define ENESIM_POOL_RECYCLE_CLASSES (sizeof(size_t) * 8 * ENESIM_POOL_RECYCLE_CLASS_STEPS)
+/* the smallest block, smaller buffers waste some memory but are rare */
+#define ENESIM_POOL_RECYCLE_MIN_SIZE 4096
+/* keep the pixels aligned after the block header */
+#define ENESIM_POOL_RECYCLE_HEADER_SIZE ((sizeof(Enesim_Pool_Recycle_Block) + \
+		ENESIM_BUFFER_SW_ALIGNMENT - 1) & ~(ENESIM_BUFFER_SW_ALIGNMENT - 1))
+
+typedef struct _Enesim_Pool_Recycle_Block
+{
+	EINA_INLIST;
+	/* the number of bytes for the pixels */
+	size_t size;
+	int cls;
+} Enesim_Pool_Recycle_Block;
+
+typedef struct _Enesim_Pool_Recycle
+{
+	/* the free blocks of every size class, the most recently freed first */
+	Eina_Inlist *blocks[ENESIM_POOL_RECYCLE_CLASSES];
+	/* the memory used by the free blocks */
+	size_t memory;
+	size_t max;
+	Eina_Bool clear;
+	unsigned int hits;
+	unsigned int misses;
+	Eina_Lock lock;
+} Enesim_Pool_Recycle;
+
+static Enesim_Pool_Descriptor _descriptor;
+
+static Enesim_Pool_Recycle * _enesim_pool_recycle_get(Enesim_Pool *p)
+{
+	if (!p || p->descriptor != &_descriptor)
+		return NULL;
+	return p->data;
+}
+
+/* round the size up to its class, the classes of a power of two are
+ * evenly spaced so at most a fourth of the memory is wasted
+ */
+static int _size_class_get(size_t bytes, size_t *size)
+{
+	size_t step;
+	int msb = 0;
+	int sub;
+
+	if (bytes < ENESIM_POOL_RECYCLE_MIN_SIZE)
+		bytes = ENESIM_POOL_RECYCLE_MIN_SIZE;
+	while ((bytes - 1) >> (msb + 1))
+		msb++;
+	step = (size_t)1 << (msb - 2);
+	sub = ((bytes - 1) >> (msb - 2)) & (ENESIM_POOL_RECYCLE_CLASS_STEPS - 1);
+	*size = ((bytes - 1) / step + 1) * step;
+	return (msb * ENESIM_POOL_RECYCLE_CLASS_STEPS) + sub;
+}
+
+static inline void * _block_data_get(Enesim_Pool_Recycle_Block *b)
+{
+	return (uint8_t *)b + ENESIM_POOL_RECYCLE_HEADER_SIZE;
+}
+
+static inline Enesim_Pool_Recycle_Block * _block_from_data(void *data)
+{
+	return (Enesim_Pool_Recycle_Block *)((uint8_t *)data -
+			ENESIM_POOL_RECYCLE_HEADER_SIZE);
+}
+
+/* release the oldest free blocks of the biggest classes until the free
+ * blocks fit on the maximum memory
+ */
+static void _evict(Enesim_Pool_Recycle *thiz)
+{
+	int i;
+
+	for (i = ENESIM_POOL_RECYCLE_CLASSES - 1; i >= 0 && thiz->memory > thiz->max; i--)
+	{
+		while (thiz->blocks[i] && thiz->memory > thiz->max)
+		{
+			Enesim_Pool_Recycle_Block *b;
+
+			b = EINA_INLIST_CONTAINER_GET(thiz->blocks[i]->last,
+					Enesim_Pool_Recycle_Block);
+			thiz->blocks[i] = eina_inlist_remove(thiz->blocks[i],
+					EINA_INLIST_GET(b));
+			thiz->memory -= b->size;
+			enesim_buffer_sw_aligned_free(b, NULL);
+		}
+	}
+}
+
+static void _flush(Enesim_Pool_Recycle *thiz)
+{
+	unsigned int i;
+
+	for (i = 0; i < ENESIM_POOL_RECYCLE_CLASSES; i++)
+	{
+		while (thiz->blocks[i])
+		{
+			Enesim_Pool_Recycle_Block *b;
+
+			b = EINA_INLIST_CONTAINER_GET(thiz->blocks[i],
+					Enesim_Pool_Recycle_Block);
+			thiz->blocks[i] = eina_inlist_remove(thiz->blocks[i],
+					thiz->blocks[i]);
+			enesim_buffer_sw_aligned_free(b, NULL);
+		}
+	}
+	thiz->memory = 0;
+}
+
+static void _data_free_cb(void *data, void *user_data)
+{
+	Enesim_Pool_Recycle *thiz = user_data;
+	Enesim_Pool_Recycle_Block *b;
+
+	if (!data) return;
+	b = _block_from_data(data);
+	if (b->size > thiz->max)
+	{
+		enesim_buffer_sw_aligned_free(b, NULL);
+		return;
+	}
+	eina_lock_take(&thiz->lock);
+	thiz->blocks[b->cls] = eina_inlist_prepend(thiz->blocks[b->cls],
+			EINA_INLIST_GET(b));
+	thiz->memory += b->size;
+	_evict(thiz);
+	eina_lock_release(&thiz->lock);
+}
+/*----------------------------------------------------------------------------*
+ *                        The Enesim's pool interface                         *
+ *----------------------------------------------------------------------------*/
+static const char * _type_get(void)
+{
+	return "enesim.pool.recycle";
+}
+
+static Eina_Bool _data_alloc(void *prv,
+		Enesim_Backend *backend,
+		void **backend_data,
+		Enesim_Buffer_Format fmt, uint32_t w, uint32_t h)
+{
+	Enesim_Pool_Recycle *thiz = prv;
+	Enesim_Pool_Recycle_Block *b = NULL;
+	Enesim_Buffer_Sw_Data *data;
+	size_t bytes;
+	size_t size;
+	size_t stride;
+	int cls;
+
+	stride = enesim_buffer_sw_aligned_stride_get(fmt, w);
+	bytes = stride * h;
+	cls = _size_class_get(bytes, &size);
+
+	eina_lock_take(&thiz->lock);
+	if (thiz->blocks[cls])
+	{
+		b = EINA_INLIST_CONTAINER_GET(thiz->blocks[cls],
+				Enesim_Pool_Recycle_Block);
+		thiz->blocks[cls] = eina_inlist_remove(thiz->blocks[cls],
+				thiz->blocks[cls]);
+		thiz->memory -= b->size;
+		thiz->hits++;
+	}
+	else
+	{
+		thiz->misses++;
+	}
+	eina_lock_release(&thiz->lock);
+
+	if (!b)
+	{
+		b = enesim_buffer_sw_aligned_alloc(ENESIM_POOL_RECYCLE_HEADER_SIZE + size);
+		if (!b)
+		{
+			ERR("Impossible to allocate %zu bytes", size);
+			return EINA_FALSE;
+		}
+		b->size = size;
+		b->cls = cls;
+	}
+	if (thiz->clear)
+		memset(_block_data_get(b), 0, bytes);
+
+	data = malloc(sizeof(Enesim_Buffer_Sw_Data));
+	if (!enesim_buffer_sw_data_set(data, fmt, _block_data_get(b), stride))
+	{
+		free(data);
+		enesim_buffer_sw_aligned_free(b, NULL);
+		return EINA_FALSE;
+	}
+	*backend = ENESIM_BACKEND_SOFTWARE;
+	*backend_data = data;
+	return EINA_TRUE;
+}
+
+static Eina_Bool _data_from(void *prv EINA_UNUSED,
+		Enesim_Backend *backend,
+		void **backend_data,
+		Enesim_Buffer_Format fmt EINA_UNUSED,
+		uint32_t w EINA_UNUSED, uint32_t h EINA_UNUSED,
+		Eina_Bool copy,
+		Enesim_Buffer_Sw_Data *src)
+{
+	Enesim_Buffer_Sw_Data *data;
+
+	if (copy)
+	{
+		ERR("Can't copy data TODO");
+		return EINA_FALSE;
+	}
+	*backend = ENESIM_BACKEND_SOFTWARE;
+	data = malloc(sizeof(Enesim_Buffer_Sw_Data));
+	*backend_data = data;
+	*data = *src;
+
+	return EINA_TRUE;
+}
+
+static void _data_free(void *prv,
+		void *backend_data,
+		Enesim_Buffer_Format fmt,
+		Eina_Bool external_allocated)
+{
+	Enesim_Pool_Recycle *thiz = prv;
+	Enesim_Buffer_Sw_Data *data = backend_data;
+
+	if (!external_allocated)
+		enesim_buffer_sw_data_free(data, fmt, _data_free_cb, thiz);
+	free(data);
+}
+
+static Eina_Bool _data_get(void *prv EINA_UNUSED,
+		void *backend_data,
+		Enesim_Buffer_Format fmt EINA_UNUSED,
+		uint32_t w EINA_UNUSED, uint32_t h EINA_UNUSED,
+		Enesim_Buffer_Sw_Data *dst)
+{
+	Enesim_Buffer_Sw_Data *data = backend_data;
+
+	*dst = *data;
+
+	return EINA_TRUE;
+}
+
+static void _free(void *prv)
+{
+	Enesim_Pool_Recycle *thiz = prv;
+
+	_flush(thiz);
+	eina_lock_free(&thiz->lock);
+	free(thiz);
+}
+
+static Enesim_Pool_Descriptor _descriptor = {
+	/* .type_get =   */ _type_get,
+	/* .data_alloc = */ _data_alloc,
+	/* .data_free =  */ _data_free,
+	/* .data_from =  */ _data_from,
+	/* .data_get =   */ _data_get,
+	/* .data_put =   */ NULL,
+	/* .free =       */ _free,
+};
+/*============================================================================*
+ *                                 Global                                     *
+ *============================================================================*/
+/** @endcond */
+/*============================================================================*
+ *                                   API                                      *
+ *============================================================================*/
+/**
+ * @brief Create a software pool that recycles the memory of the freed buffers
+ * @param[in] max The maximum number of bytes the freed buffers can keep
+ * @return The newly allocated pool
+ *
+ * The memory of a freed buffer is kept on the free list of its size class
+ * and given to the next buffer of the same class. Whenever the kept memory
+ * is higher than @p max, the oldest memory of the biggest classes is
+ * released.
+ */
+EAPI Enesim_Pool * enesim_pool_recycle_new(size_t max)
+{
+	Enesim_Pool_Recycle *thiz;
+	Enesim_Pool *p;
+
+	thiz = calloc(1, sizeof(Enesim_Pool_Recycle));
+	thiz->max = max;
+	thiz->clear = EINA_TRUE;
+	eina_lock_new(&thiz->lock);
+
+	p = enesim_pool_new(&_descriptor, thiz);
+	if (!p)
+	{
+		eina_lock_free(&thiz->lock);
+		free(thiz);
+		return NULL;
+	}
+
+	return p;
+}
+
+/**
+ * @brief Set if the recycled memory must be cleared
+ * @param[in] p The recycle pool
+ * @param[in] clear EINA_TRUE to clear the pixels of every new buffer,
+ * EINA_FALSE to leave them uninitialized
+ *
+ * By default the pixels of every new buffer are cleared. In case the users
+ * of the pool always overwrite the whole buffer, like a surface that is
+ * always drawn with the fill rop, the clear can be avoided.
+ */
+EAPI void enesim_pool_recycle_clear_set(Enesim_Pool *p, Eina_Bool clear)
+{
+	Enesim_Pool_Recycle *thiz;
+
+	thiz = _enesim_pool_recycle_get(p);
+	if (!thiz) return;
+	thiz->clear = clear;
+}
+
+/**
+ * @brief Get the statistics of a recycle pool
+ * @param[in] p The recycle pool
+ * @param[out] hits The number of buffers allocated with recycled memory
+ * @param[out] misses The number of buffers allocated with new memory
+ * @param[out] memory The number of bytes kept from the freed buffers
+ */
+EAPI void enesim_pool_recycle_stats_get(Enesim_Pool *p, unsigned int *hits,
+		unsigned int *misses, size_t *memory)
+{
+	Enesim_Pool_Recycle *thiz;
+
+	thiz = _enesim_pool_recycle_get(p);
+	if (!thiz) return;
+	eina_lock_take(&thiz->lock);
+	if (hits) *hits = thiz->hits;
+	if (misses) *misses = thiz->misses;
+	if (memory) *memory = thiz->memory;
+	eina_lock_release(&thiz->lock);
+}
+
+/**
+ * @brief Release the memory kept from the freed buffers
+ * @param[in] p The recycle pool
+ */
+EAPI void enesim_pool_recycle_flush(Enesim_Pool *p)
+{
+	Enesim_Pool_Recycle *thiz;
+
+	thiz = _enesim_pool_recycle_get(p);
+	if (!thiz) return;
+	eina_lock_take(&thiz->lock);
+	_flush(thiz);
+	eina_lock_release(&thiz->lock);
+}
@@ -32,11 +32,6 @@
 
 static Enesim_Pool *_sw_pool = NULL;
 
-static void _data_free_cb(void *data, void *user_data EINA_UNUSED)
-{
-	free(data);
-}
-
 /*----------------------------------------------------------------------------*
  *                        The Enesim's pool interface                         *
  *----------------------------------------------------------------------------*/
@@ -56,7 +51,7 @@ static Eina_Bool _data_alloc(void *prv EINA_UNUSED,
 	data = malloc(sizeof(Enesim_Buffer_Sw_Data));
 	*backend = ENESIM_BACKEND_SOFTWARE;
 	*backend_data = data;
-	ret = enesim_buffer_sw_data_alloc(data, fmt, w, h);
+	ret = enesim_buffer_sw_data_aligned_alloc(data, fmt, w, h);
 	if (!ret)
 	{
 		free(data);
@@ -96,7 +91,8 @@ static void _data_free(void *prv EINA_UNUSED, void *backend_data,
 {
 	Enesim_Buffer_Sw_Data *data = backend_data;
 	if (!external_allocated)
-		enesim_buffer_sw_data_free(data, fmt, _data_free_cb, NULL);
+		enesim_buffer_sw_data_free(data, fmt,
+				enesim_buffer_sw_aligned_free, NULL);
 	free(data);
 }
 
@@ -291,6 +291,19 @@ static void _background_sw_hints_get(Enesim_Renderer *r EINA_UNUSED,
 			ENESIM_RENDERER_SW_HINT_MASK;
 }
 
+static Eina_Bool _background_opaque_bounds_get(Enesim_Renderer *r,
+		Eina_Rectangle *rect)
+{
+	Enesim_Renderer_Background *thiz;
+
+	thiz = ENESIM_RENDERER_BACKGROUND(r);
+	if (enesim_color_alpha_get(thiz->color) != 0xff)
+		return EINA_FALSE;
+	eina_rectangle_coords_from(rect, INT_MIN / 2, INT_MIN / 2, INT_MAX,
+			INT_MAX);
+	return EINA_TRUE;
+}
+
 static Eina_Bool _background_has_changed(Enesim_Renderer *r)
 {
 	Enesim_Renderer_Background *thiz;
@@ -319,6 +332,7 @@ static void _enesim_renderer_background_class_init(void *k)
 	klass->damages_get = NULL;
 	klass->has_changed =  _background_has_changed;
 	klass->alpha_hints_get = NULL;
+	klass->opaque_bounds_get = _background_opaque_bounds_get;
 	klass->sw_hints_get = _background_sw_hints_get;
 	klass->sw_setup = _background_sw_setup;
 	klass->sw_cleanup = _background_sw_cleanup;
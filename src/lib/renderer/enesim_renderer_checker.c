@@ -42,6 +42,7 @@
 #endif
 
 #include "enesim_color_private.h"
+#include "enesim_color_fill_private.h"
 #include "enesim_coord_private.h"
 #include "enesim_surface_private.h"
 #include "enesim_renderer_private.h"
@@ -55,6 +56,9 @@
  *                                  Local                                     *
  *============================================================================*/
 /** @cond internal */
+/* the number of runs to describe at once on the identity span */
+#define ENESIM_RENDERER_CHECKER_RUNS 16
+
 #define ENESIM_RENDERER_CHECKER(o) ENESIM_OBJECT_INSTANCE_CHECK(o,		\
 		Enesim_Renderer_Checker,					\
 		enesim_renderer_checker_descriptor_get())
@@ -83,6 +87,7 @@ typedef struct _Enesim_Renderer_Checker
 	Eina_F16p16 ww, hh;
 	Eina_F16p16 ww2, hh2;
 	Eina_Bool do_mask;
+	Eina_Bool do_runs;
 	Enesim_Renderer *mask;
 } Enesim_Renderer_Checker;
 
@@ -216,19 +221,19 @@ static void _checker_state_cleanup(Enesim_Renderer_Checker *thiz)
 /*----------------------------------------------------------------------------*
  *                               Span functions                               *
  *----------------------------------------------------------------------------*/
-static void _span_identity(Enesim_Renderer *r,
-		int x, int y, int len, void *ddata)
+/* on the identity case every row is made of runs of the square width,
+ * describe the runs of a span starting at x
+ */
+static int _checker_identity_runs(Enesim_Renderer_Checker *thiz,
+		int x, int y, int len, Enesim_Renderer_Sw_Run *runs, int max)
 {
-	Enesim_Renderer_Checker *thiz;
 	Eina_F16p16 yy, xx;
+	uint32_t color[2];
 	int w2;
 	int h2;
-	uint32_t color[2];
-	uint32_t *dst = ddata;
-	uint32_t *end = dst + len;
-	int sy;
+	int sx, sy;
+	int n = 0;
 
-	thiz = ENESIM_RENDERER_CHECKER(r);
 	w2 = thiz->current.sw * 2;
 	h2 = thiz->current.sh * 2;
 	color[0] = thiz->final_color1;
@@ -248,47 +253,98 @@ static void _span_identity(Enesim_Renderer *r,
 		color[0] = thiz->final_color2;
 		color[1] = thiz->final_color1;
 	}
-	/* do mask */
+	sx = ((xx >> 16) % w2);
+	if (sx < 0)
+	{
+		sx += w2;
+	}
+
+	while (len > 0 && n < max)
+	{
+		int rlen;
+
+		if (sx >= thiz->current.sw)
+		{
+			runs[n].color = color[0];
+			rlen = w2 - sx;
+		}
+		else
+		{
+			runs[n].color = color[1];
+			rlen = thiz->current.sw - sx;
+		}
+		if (rlen > len)
+			rlen = len;
+		runs[n].len = rlen;
+		runs[n].solid = EINA_TRUE;
+		sx = (sx + rlen) % w2;
+		len -= rlen;
+		n++;
+	}
+	return n;
+}
+
+static void _span_identity(Enesim_Renderer *r,
+		int x, int y, int len, void *ddata)
+{
+	Enesim_Renderer_Checker *thiz;
+	Enesim_Renderer_Sw_Run runs[ENESIM_RENDERER_CHECKER_RUNS];
+	uint32_t *dst = ddata;
+	uint32_t *end = dst + len;
+
+	thiz = ENESIM_RENDERER_CHECKER(r);
+	/* with a mask, first draw it and then multiply every pixel by the
+	 * color of its run
+	 */
 	if (thiz->do_mask)
 		enesim_renderer_sw_draw(thiz->mask, x, y, len, dst);
 
 	while (dst < end)
 	{
-		int sx;
-		uint32_t p0;
-		int ma = 255;
+		int n;
+		int i;
 
-		if (thiz->do_mask)
+		n = _checker_identity_runs(thiz, x, y, end - dst, runs,
+				ENESIM_RENDERER_CHECKER_RUNS);
+		for (i = 0; i < n; i++)
 		{
-			ma = (*dst) >> 24;
-			if (!ma)
+			uint32_t *rend = dst + runs[i].len;
+
+			x += runs[i].len;
+			if (!thiz->do_mask)
 			{
-				dst++;
-				goto done;
+				enesim_color_fill_sp_none_color_none(dst,
+						runs[i].len, runs[i].color);
+				dst = rend;
+				continue;
+			}
+			for (; dst < rend; dst++)
+			{
+				uint32_t p0 = runs[i].color;
+				int ma;
+
+				ma = (*dst) >> 24;
+				if (!ma)
+					continue;
+				if (ma < 255)
+					p0 = enesim_color_mul_sym(ma, p0);
+				*dst = p0;
 			}
 		}
-		sx = ((xx >> 16) % w2);
-		if (sx < 0)
-		{
-			sx += w2;
-		}
-		/* choose the correct color */
-		if (sx >= thiz->current.sw)
-		{
-			p0 = color[0];
-		}
-		else
-		{
-			p0 = color[1];
-		}
-		if (ma < 255)
-			p0 = enesim_color_mul_sym(ma, p0);
-		*dst++ = p0;
-done:
-		xx += EINA_F16P16_ONE;
 	}
 }
 
+static int _checker_sw_runs_get(Enesim_Renderer *r, int x, int y, int len,
+		Enesim_Renderer_Sw_Run *runs, int max)
+{
+	Enesim_Renderer_Checker *thiz;
+
+	thiz = ENESIM_RENDERER_CHECKER(r);
+	if (!thiz->do_runs)
+		return 0;
+	return _checker_identity_runs(thiz, x, y, len, runs, max);
+}
+
 static void _span_affine(Enesim_Renderer *r,
 		int x, int y, int len, void *ddata)
 {
@@ -501,6 +557,7 @@ static void _checker_sw_cleanup(Enesim_Renderer *r, Enesim_Surface *s EINA_UNUSE
 		thiz->mask = NULL;
 	}
 	thiz->do_mask = EINA_FALSE;
+	thiz->do_runs = EINA_FALSE;
 	_checker_state_cleanup(thiz);
 }
 
@@ -537,6 +594,10 @@ static Eina_Bool _checker_sw_setup(Enesim_Renderer *r,
 	{
 		case ENESIM_MATRIX_TYPE_IDENTITY:
 		*fill = _span_identity;
+		/* the runs do not know about the mask */
+		if (!thiz->do_mask && thiz->current.sw > 0 &&
+				thiz->current.sh > 0)
+			thiz->do_runs = EINA_TRUE;
 		break;
 
 		case ENESIM_MATRIX_TYPE_AFFINE:
@@ -722,6 +783,7 @@ static void _enesim_renderer_checker_class_init(void *k)
 	klass->sw_hints_get = _checker_sw_hints_get;
 	klass->sw_setup = _checker_sw_setup;
 	klass->sw_cleanup = _checker_sw_cleanup;
+	klass->sw_runs_get = _checker_sw_runs_get;
 #if BUILD_OPENCL
 	klass->opencl_kernel_get = _checker_opencl_kernel_get;
 	klass->opencl_kernel_setup = _checker_opencl_kernel_setup;
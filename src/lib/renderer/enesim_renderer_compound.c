@@ -42,6 +42,7 @@
 #include "Enesim_OpenCL.h"
 #endif
 
+#include "enesim_color_private.h"
 #include "enesim_renderer_private.h"
 #include "enesim_buffer_private.h"
 #include "enesim_surface_private.h"
@@ -71,8 +72,18 @@ struct _Enesim_Renderer_Compound_Layer
 	int ref;
 	/* generated at state setup */
 	Eina_Rectangle destination_bounds;
+	/* the area where everything below this layer is not visible */
+	Eina_Rectangle cover;
 };
 
+/* a layer to draw on a span, with the interval the upper layers cover */
+typedef struct _Enesim_Renderer_Compound_Span_Layer
+{
+	Enesim_Renderer_Compound_Layer *l;
+	int cx1;
+	int cx2;
+} Enesim_Renderer_Compound_Span_Layer;
+
 typedef struct _Enesim_Renderer_Compound
 {
 	Enesim_Renderer parent;
@@ -81,6 +92,7 @@ typedef struct _Enesim_Renderer_Compound
 	/* private */
 	Enesim_Renderer_State rstate;
 	Eina_List *visible_layers; /* FIXME maybe is time to change from lists to arrays */
+	int num_visible_layers;
 	Eina_List *added;
 	Eina_List *removed;
 #if BUILD_OPENGL
@@ -95,6 +107,8 @@ typedef struct _Enesim_Renderer_Compound
 
 	Eina_Bool changed : 1;
 	Eina_Bool background_enabled : 1;
+	Eina_Bool has_covers : 1;
+	Eina_Bool front_to_back : 1;
 } Enesim_Renderer_Compound;
 
 typedef struct _Enesim_Renderer_Compound_Class {
@@ -144,6 +158,81 @@ static inline void _compound_layer_span_draw(Enesim_Renderer_Compound_Layer *l,
 	enesim_renderer_sw_draw(l->r, lbounds.x, lbounds.y, lbounds.w, dst + offset);
 }
 
+/* draw only the parts of the span that are not covered by the upper layers */
+static inline void _compound_layer_span_draw_uncovered(
+		Enesim_Renderer_Compound_Layer *l, Eina_Rectangle *span,
+		void *ddata, int cx1, int cx2)
+{
+	Eina_Rectangle sub;
+	uint32_t *dst = ddata;
+	int end = span->x + span->w;
+
+	if (cx1 >= cx2 || cx2 <= span->x || cx1 >= end)
+	{
+		_compound_layer_span_draw(l, span, ddata);
+		return;
+	}
+	if (cx1 > span->x)
+	{
+		eina_rectangle_coords_from(&sub, span->x, span->y,
+				cx1 - span->x, 1);
+		_compound_layer_span_draw(l, &sub, dst);
+	}
+	if (cx2 < end)
+	{
+		eina_rectangle_coords_from(&sub, cx2, span->y, end - cx2, 1);
+		_compound_layer_span_draw(l, &sub, dst + (cx2 - span->x));
+	}
+}
+
+/* a layer that fills replaces everything below it on its bounds, a layer
+ * that blends only on its opaque area
+ */
+static inline Eina_Bool _compound_layer_cover_setup(Enesim_Renderer_Compound_Layer *l)
+{
+	if (l->rop == ENESIM_ROP_FILL)
+	{
+		l->cover = l->destination_bounds;
+		return EINA_TRUE;
+	}
+	if (enesim_renderer_opaque_bounds_get(l->r, &l->cover, 0, 0))
+		return EINA_TRUE;
+	eina_rectangle_coords_from(&l->cover, 0, 0, 0, 0);
+	return EINA_FALSE;
+}
+
+/* merge the cover of a layer into the covered interval of a span. In case
+ * both do not touch, keep the longest one
+ */
+static inline void _compound_layer_cover_merge(Enesim_Renderer_Compound_Layer *l,
+		int y, int *cx1, int *cx2)
+{
+	int x1, x2;
+
+	if (!eina_rectangle_is_valid(&l->cover))
+		return;
+	if (y < l->cover.y || y >= l->cover.y + l->cover.h)
+		return;
+
+	x1 = l->cover.x;
+	x2 = l->cover.x + l->cover.w;
+	if (*cx1 >= *cx2)
+	{
+		*cx1 = x1;
+		*cx2 = x2;
+	}
+	else if (x1 <= *cx2 && *cx1 <= x2)
+	{
+		if (x1 < *cx1) *cx1 = x1;
+		if (x2 > *cx2) *cx2 = x2;
+	}
+	else if (x2 - x1 > *cx2 - *cx1)
+	{
+		*cx1 = x1;
+		*cx2 = x2;
+	}
+}
+
 static Eina_Bool _compound_state_setup(Enesim_Renderer_Compound *thiz,
 		Enesim_Renderer *r, Enesim_Surface *s, Enesim_Rop rop EINA_UNUSED,
 		Enesim_Log **l)
@@ -168,6 +257,8 @@ static Eina_Bool _compound_state_setup(Enesim_Renderer_Compound *thiz,
 		eina_list_free(thiz->visible_layers);
 		thiz->visible_layers = NULL;
 	}
+	thiz->num_visible_layers = 0;
+	thiz->has_covers = EINA_FALSE;
 	EINA_LIST_FREE(thiz->added, layer)
 	{
 		/* add the recently added layers to the layers to calculate */
@@ -202,6 +293,9 @@ static Eina_Bool _compound_state_setup(Enesim_Renderer_Compound *thiz,
 		/* ok the layer pass the whole pre/post/setup process, add it to the visible layers */
 		DBG("Adding layer '%s' on '%s'", layer->r->name, r->name);
 		thiz->visible_layers = eina_list_append(thiz->visible_layers, layer);
+		thiz->num_visible_layers++;
+		if (_compound_layer_cover_setup(layer))
+			thiz->has_covers = EINA_TRUE;
 	}
 
 	/* TODO in case every layer failed and no background enabled, is an error */
@@ -401,12 +495,160 @@ static inline void _compound_layer_opencl_draw(
 }
 #endif
 
+/* Go from the top layer to the bottom one keeping track of the interval
+ * of the span the upper layers cover, until the whole span is covered.
+ * Then draw back to front only what is not covered
+ */
+static inline void _compound_span_layer_draw_covered(Enesim_Renderer_Compound *thiz,
+		Eina_Rectangle *span, void *ddata)
+{
+	Enesim_Renderer_Compound_Span_Layer *layers;
+	Eina_List *ll;
+	int cx1 = 0;
+	int cx2 = 0;
+	int n = 0;
+
+	layers = alloca(sizeof(Enesim_Renderer_Compound_Span_Layer) *
+			(thiz->num_visible_layers + 1));
+	for (ll = eina_list_last(thiz->visible_layers); ll; ll = eina_list_prev(ll))
+	{
+		Enesim_Renderer_Compound_Layer *l;
+
+		l = eina_list_data_get(ll);
+		layers[n].l = l;
+		layers[n].cx1 = cx1;
+		layers[n].cx2 = cx2;
+		n++;
+
+		_compound_layer_cover_merge(l, span->y, &cx1, &cx2);
+		if (cx1 <= span->x && cx2 >= span->x + span->w)
+			goto draw;
+	}
+	if (thiz->background_enabled)
+	{
+		layers[n].l = &thiz->background;
+		layers[n].cx1 = cx1;
+		layers[n].cx2 = cx2;
+		n++;
+	}
+draw:
+	while (n--)
+	{
+		_compound_layer_span_draw_uncovered(layers[n].l, span, ddata,
+				layers[n].cx1, layers[n].cx2);
+	}
+}
+
+/* compose the layer pixels under the accumulated ones, the pixels that
+ * become opaque are marked as done
+ */
+static inline void _compound_span_under(uint32_t *acc, uint32_t *src,
+		uint8_t *done, int len)
+{
+	while (len--)
+	{
+		if (!*done)
+		{
+			uint16_t a = 256 - enesim_color_alpha_get(*acc);
+
+			*acc = *acc + enesim_color_mul_256(a, *src);
+			if (enesim_color_alpha_get(*acc) == 0xff)
+				*done = 1;
+		}
+		acc++;
+		src++;
+		done++;
+	}
+}
+
+/* Draw a layer under the accumulated pixels on the interval of the span
+ * that is not done yet
+ */
+static inline void _compound_layer_span_draw_under(
+		Enesim_Renderer_Compound_Layer *l, Eina_Rectangle *span,
+		int *sx1, int *sx2, uint32_t *acc, uint32_t *tmp, uint8_t *done)
+{
+	Eina_Rectangle lbounds;
+	int x1, x2;
+	int offset;
+
+	lbounds = l->destination_bounds;
+	x1 = lbounds.x > *sx1 ? lbounds.x : *sx1;
+	x2 = lbounds.x + lbounds.w < *sx2 ? lbounds.x + lbounds.w : *sx2;
+	if (span->y < lbounds.y || span->y >= lbounds.y + lbounds.h)
+		return;
+	/* skip the pixels already done at both ends */
+	while (x1 < x2 && done[x1 - span->x]) x1++;
+	while (x2 > x1 && done[x2 - 1 - span->x]) x2--;
+	if (x1 >= x2)
+		return;
+
+	offset = x1 - span->x;
+	/* whatever the rop is, draw the layer alone */
+	memset(tmp + offset, 0, (x2 - x1) * sizeof(uint32_t));
+	enesim_renderer_sw_draw(l->r, x1, span->y, x2 - x1, tmp + offset);
+	_compound_span_under(acc + offset, tmp + offset, done + offset,
+			x2 - x1);
+	/* nothing below a filled area is visible */
+	if (l->rop == ENESIM_ROP_FILL)
+		memset(done + offset, 1, x2 - x1);
+
+	/* shrink the interval of the span that is not done */
+	while (*sx1 < *sx2 && done[*sx1 - span->x]) (*sx1)++;
+	while (*sx2 > *sx1 && done[*sx2 - 1 - span->x]) (*sx2)--;
+}
+
+/* Go from the top layer to the bottom one accumulating the layers with the
+ * under operator, until every pixel of the span is opaque
+ */
+static inline void _compound_span_layer_draw_front_to_back(
+		Enesim_Renderer_Compound *thiz, Eina_Rectangle *span,
+		void *ddata)
+{
+	Eina_List *ll;
+	uint32_t *tmp;
+	uint8_t *done;
+	int sx1 = span->x;
+	int sx2 = span->x + span->w;
+
+	tmp = alloca(span->w * sizeof(uint32_t));
+	done = alloca(span->w);
+	memset(done, 0, span->w);
+	memset(ddata, 0, span->w * sizeof(uint32_t));
+
+	for (ll = eina_list_last(thiz->visible_layers); ll; ll = eina_list_prev(ll))
+	{
+		Enesim_Renderer_Compound_Layer *l;
+
+		l = eina_list_data_get(ll);
+		_compound_layer_span_draw_under(l, span, &sx1, &sx2, ddata,
+				tmp, done);
+		if (sx1 >= sx2)
+			return;
+	}
+	if (thiz->background_enabled)
+	{
+		_compound_layer_span_draw_under(&thiz->background, span,
+				&sx1, &sx2, ddata, tmp, done);
+	}
+}
+
 static inline void _compound_span_layer_draw(Enesim_Renderer_Compound *thiz, int x, int y, int len, void *ddata)
 {
 	Eina_List *ll;
 	Eina_Rectangle span;
 
 	eina_rectangle_coords_from(&span, x, y, len, 1);
+	if (thiz->front_to_back)
+	{
+		_compound_span_layer_draw_front_to_back(thiz, &span, ddata);
+		return;
+	}
+	if (thiz->has_covers)
+	{
+		_compound_span_layer_draw_covered(thiz, &span, ddata);
+		return;
+	}
 	/* first the background */
 	if (thiz->background_enabled)
 	{
@@ -433,7 +675,8 @@ static void _compound_fill_span_blend_layer(Enesim_Renderer *r,
 	/* we might need to add this memset in case the layers for this span dont fill the whole area
 	 * TODO we can do this smarter and just fill the areas that the renderers did not draw
 	 */
-	memset(ddata, 0, len * sizeof(uint32_t));
+	if (!thiz->front_to_back)
+		memset(ddata, 0, len * sizeof(uint32_t));
 	_compound_span_layer_draw(thiz, x, y, len, ddata);
 }
 
@@ -490,7 +733,10 @@ static void _compound_sw_hints(Enesim_Renderer *r, Enesim_Rop rop,
 		Enesim_Renderer_Compound_Layer *l = eina_list_data_get(ll);
 		_compound_layer_sw_hints_merge(l, rop, &same_rop, &h);
 	}
-	if (same_rop)
+	/* the layers are accumulated on their own, the result must be
+	 * composed with the renderer rop
+	 */
+	if (same_rop && !thiz->front_to_back)
 		h |= ENESIM_RENDERER_SW_HINT_ROP;
 	else
 		h &= ~ENESIM_RENDERER_SW_HINT_ROP;
@@ -605,6 +851,44 @@ no_layers:
 	}
 }
 
+static void _compound_layer_opaque_merge(Enesim_Renderer_Compound_Layer *l,
+		Eina_Rectangle *opaque)
+{
+	Eina_Rectangle tmp;
+
+	/* a fill might replace the opaque area with something transparent */
+	if (l->rop == ENESIM_ROP_FILL && eina_rectangle_is_valid(opaque))
+	{
+		enesim_renderer_destination_bounds_get(l->r, &tmp, 0, 0, NULL);
+		if (eina_rectangle_intersection(&tmp, opaque))
+			eina_rectangle_coords_from(opaque, 0, 0, 0, 0);
+	}
+	if (!enesim_renderer_opaque_bounds_get(l->r, &tmp, 0, 0))
+		return;
+	/* keep the biggest area */
+	if (!eina_rectangle_is_valid(opaque) ||
+			((double)tmp.w * tmp.h > (double)opaque->w * opaque->h))
+		*opaque = tmp;
+}
+
+static Eina_Bool _compound_opaque_bounds_get(Enesim_Renderer *r,
+		Eina_Rectangle *rect)
+{
+	Enesim_Renderer_Compound *thiz;
+	Enesim_Renderer_Compound_Layer *l;
+	Eina_List *ll;
+
+	thiz = ENESIM_RENDERER_COMPOUND(r);
+	eina_rectangle_coords_from(rect, 0, 0, 0, 0);
+	if (thiz->background_enabled)
+		_compound_layer_opaque_merge(&thiz->background, rect);
+	EINA_LIST_FOREACH(thiz->layers, ll, l)
+		_compound_layer_opaque_merge(l, rect);
+	EINA_LIST_FOREACH(thiz->added, ll, l)
+		_compound_layer_opaque_merge(l, rect);
+	return eina_rectangle_is_valid(rect);
+}
+
 static void _compound_features_get(Enesim_Renderer *r EINA_UNUSED,
 		int *features)
 {
@@ -881,6 +1165,7 @@ static void _enesim_renderer_compound_class_init(void *k)
 	klass->is_inside = _compound_is_inside;
 	klass->damages_get = _compound_damage;
 	klass->has_changed = _compound_has_changed;
+	klass->opaque_bounds_get = _compound_opaque_bounds_get;
 	klass->sw_hints_get = _compound_sw_hints;
 	klass->sw_setup = _compound_sw_setup;
 	klass->sw_cleanup = _compound_sw_cleanup;
@@ -1303,3 +1588,41 @@ EAPI Enesim_Color enesim_renderer_compound_background_color_get(Enesim_Renderer
 	thiz = ENESIM_RENDERER_COMPOUND(r);
 	return enesim_renderer_background_color_get(thiz->background.r);
 }
+
+/**
+ * @brief Sets the order of composition of the layers
+ * @ender_prop{front_to_back}
+ * @param[in] r The compound renderer
+ * @param[in] enable @c EINA_TRUE to compose from the top layer to the bottom
+ * one, @c EINA_FALSE to compose from the bottom to the top
+ *
+ * When composing from front to back, the layers are accumulated under the
+ * upper ones. Once a pixel becomes fully opaque the layers below are not
+ * drawn for it. This is useful for deep stacks of semi transparent layers
+ * over opaque content.
+ */
+EAPI void enesim_renderer_compound_front_to_back_set(Enesim_Renderer *r, Eina_Bool enable)
+{
+	Enesim_Renderer_Compound *thiz;
+
+	thiz = ENESIM_RENDERER_COMPOUND(r);
+	if (thiz->front_to_back == enable)
+		return;
+	thiz->front_to_back = enable;
+	thiz->changed = EINA_TRUE;
+}
+
+/**
+ * @brief Gets the order of composition of the layers
+ * @ender_prop{front_to_back}
+ * @param[in] r The compound renderer
+ * @return @c EINA_TRUE if the layers are composed from front to back,
+ * @c EINA_FALSE otherwise
+ */
+EAPI Eina_Bool enesim_renderer_compound_front_to_back_get(Enesim_Renderer *r)
+{
+	Enesim_Renderer_Compound *thiz;
+
+	thiz = ENESIM_RENDERER_COMPOUND(r);
+	return thiz->front_to_back;
+}
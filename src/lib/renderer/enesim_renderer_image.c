@@ -1610,6 +1610,32 @@ static Eina_Bool _image_sw_state_setup(Enesim_Renderer *r,
 	return EINA_TRUE;
 }
 
+static Eina_Bool _image_opaque_bounds_get(Enesim_Renderer *r,
+		Eina_Rectangle *rect)
+{
+	Enesim_Renderer_Image *thiz;
+	double ox, oy;
+	double x1, y1, x2, y2;
+
+	thiz = ENESIM_RENDERER_IMAGE(r);
+	if (!thiz->current.s)
+		return EINA_FALSE;
+	if (enesim_surface_alpha_hint_get(thiz->current.s) != ENESIM_ALPHA_HINT_OPAQUE)
+		return EINA_FALSE;
+	if (enesim_renderer_transformation_type_get(r) != ENESIM_MATRIX_TYPE_IDENTITY)
+		return EINA_FALSE;
+
+	enesim_renderer_origin_get(r, &ox, &oy);
+	x1 = thiz->current.x + ox;
+	y1 = thiz->current.y + oy;
+	x2 = x1 + thiz->current.w;
+	y2 = y1 + thiz->current.h;
+	/* the edges are interpolated with the outside */
+	eina_rectangle_coords_from(rect, ceil(x1) + 1, ceil(y1) + 1,
+			floor(x2) - ceil(x1) - 2, floor(y2) - ceil(y1) - 2);
+	return eina_rectangle_is_valid(rect);
+}
+
 static void _image_features_get(Enesim_Renderer *r EINA_UNUSED,
 		int *features)
 {
@@ -1759,6 +1785,7 @@ static void _enesim_renderer_image_class_init(void *k)
 	klass->features_get = _image_features_get;
 	klass->damages_get = _image_damages;
 	klass->has_changed = _image_has_changed;
+	klass->opaque_bounds_get = _image_opaque_bounds_get;
 	klass->sw_hints_get = _image_sw_image_hints;
 	klass->sw_setup = _image_sw_state_setup;
 	klass->sw_cleanup = _image_sw_state_cleanup;
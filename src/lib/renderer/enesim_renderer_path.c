@@ -257,10 +257,14 @@ static void _path_sw_hints(Enesim_Renderer *r EINA_UNUSED, Enesim_Rop rop
 static Eina_Bool _path_sw_setup(Enesim_Renderer *r ,Enesim_Surface *s,
 		Enesim_Rop rop, Enesim_Renderer_Sw_Fill *draw, Enesim_Log **l)
 {
+	Enesim_Renderer_Path *thiz;
+
 	if (!_path_setup(r, s, rop, l))
 		return EINA_FALSE;
 
+	thiz = ENESIM_RENDERER_PATH(r);
 	*draw = _path_span;
+	enesim_renderer_sw_delegate_set(r, thiz->current);
 	return EINA_TRUE;
 }
 
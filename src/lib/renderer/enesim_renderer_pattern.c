@@ -32,6 +32,7 @@
 #include "enesim_object_class.h"
 #include "enesim_object_instance.h"
 #include "enesim_coord_private.h"
+#include "enesim_draw_cache_private.h"
 
 #ifdef BUILD_OPENCL
 #include "Enesim_OpenCL.h"
@@ -67,7 +68,10 @@ typedef struct _Enesim_Renderer_Pattern {
 	/* private */
 	/* generated at state setup */
 	Enesim_Surface *src;
-	Enesim_Surface *cache;
+	/* the tile drawn by the source renderer, only the damaged areas of
+	 * the source are drawn again
+	 */
+	Enesim_Draw_Cache *cache;
 	int src_xx;
 	int src_yy;
 	int src_ww;
@@ -76,10 +80,12 @@ typedef struct _Enesim_Renderer_Pattern {
 	int src_h;
 	Enesim_Matrix_F16p16 matrix;
 	Eina_Bool changed : 1;
-	Eina_Bool force_redraw : 1;
 	/* for sw */
 	size_t sstride;
 	uint32_t *ssrc;
+	/* the position of the tile when no sampling is needed */
+	int src_ox;
+	int src_oy;
 } Enesim_Renderer_Pattern;
 
 typedef struct _Enesim_Renderer_Pattern_Class {
@@ -94,7 +100,6 @@ static Eina_Bool _pattern_state_setup(Enesim_Renderer *r,
 	int sx, sy, sw, sh;
 
  	thiz = ENESIM_RENDERER_PATTERN(r);
-	thiz->force_redraw = EINA_FALSE;
 
 	/* setup the renderer/surface */
 	if (!thiz->src_r && !thiz->src_s)
@@ -105,48 +110,49 @@ static Eina_Bool _pattern_state_setup(Enesim_Renderer *r,
 
 	if (thiz->src_r)
 	{
-		thiz->force_redraw = enesim_renderer_has_changed(thiz->src_r);
-
-		enesim_renderer_destination_bounds_get(thiz->src_r, &bounds, 0, 0, NULL);
-		if (thiz->cache)
-		{
-			int old_sw, old_sh;
-
-			enesim_surface_size_get(thiz->cache, &old_sw, &old_sh);
-			if (old_sw != bounds.w || old_sh != bounds.h)
-			{
-				enesim_surface_unref(thiz->cache);
-				thiz->cache = NULL;
-			}
-		}
-
-		if (!thiz->cache)
+		Enesim_Buffer_Sw_Data sw_data;
+		Enesim_Renderer *old_r;
+		Enesim_Pool *pool;
+		Eina_Bool ret;
+
+		if (!enesim_renderer_setup(thiz->src_r, s, ENESIM_ROP_FILL, l))
+			return EINA_FALSE;
+		enesim_draw_cache_renderer_get(thiz->cache, &old_r);
+		if (old_r != thiz->src_r)
+			enesim_draw_cache_renderer_set(thiz->cache,
+					enesim_renderer_ref(thiz->src_r));
+		if (old_r)
+			enesim_renderer_unref(old_r);
+
+		/* allocate the tile like the destination surface */
+		pool = s ? enesim_surface_pool_get(s) : NULL;
+		ret = enesim_draw_cache_setup_sw(thiz->cache,
+				ENESIM_FORMAT_ARGB8888, pool);
+		enesim_pool_unref(pool);
+		if (!ret ||
+				!enesim_draw_cache_geometry_get(thiz->cache, &bounds) ||
+				!bounds.w || !bounds.h)
 		{
-			Enesim_Pool *pool;
-
-			pool = enesim_surface_pool_get(s);
-			thiz->cache = enesim_surface_new_pool_from(ENESIM_FORMAT_ARGB8888,
-					bounds.w, bounds.h, pool);
-			if (!thiz->cache)
-			{
-				ENESIM_RENDERER_LOG(r, l,
-						"Impossible to create the surface of size %d %d",
-						bounds.w, bounds.h);
-				return EINA_FALSE;
-			}
-			thiz->force_redraw = EINA_TRUE;
+			ENESIM_RENDERER_LOG(r, l, "Impossible to setup the tile of "
+					"the source renderer");
+			enesim_renderer_cleanup(thiz->src_r, s);
+			return EINA_FALSE;
 		}
-		if (thiz->force_redraw)
+		/* the whole tile is used, so draw every damaged area now,
+		 * the source is not needed anymore
+		 */
+		ret = enesim_draw_cache_map_sw(thiz->cache, NULL, &sw_data);
+		enesim_renderer_cleanup(thiz->src_r, s);
+		if (!ret)
 		{
-			if (!enesim_renderer_draw(thiz->src_r, thiz->cache, ENESIM_ROP_FILL,
-					NULL, -bounds.x, -bounds.y, NULL))
-			{
-				ENESIM_RENDERER_LOG(r, l, "Failed to draw the source renderer");
-				return EINA_FALSE;
-			}
+			ENESIM_RENDERER_LOG(r, l, "Impossible to draw the tile of "
+					"the source renderer");
+			return EINA_FALSE;
 		}
-		thiz->src = enesim_surface_ref(thiz->cache);
-		enesim_surface_size_get(thiz->cache, &sw, &sh);
+		thiz->ssrc = sw_data.argb8888.plane0;
+		thiz->sstride = sw_data.argb8888.plane0_stride;
+		sw = bounds.w;
+		sh = bounds.h;
 		sx = bounds.x;
 		sy = bounds.y;
 	}
@@ -172,12 +178,12 @@ static void _pattern_state_cleanup(Enesim_Renderer *r, Enesim_Surface *s EINA_UN
 	Enesim_Renderer_Pattern *thiz;
 
  	thiz = ENESIM_RENDERER_PATTERN(r);
-	thiz->force_redraw = EINA_FALSE;
 	if (thiz->src)
 	{
 		enesim_surface_unref(thiz->src);
 		thiz->src = NULL;
 	}
+	thiz->ssrc = NULL;
 	thiz->past = thiz->current;
 	thiz->changed = EINA_FALSE;
 }
@@ -240,6 +246,33 @@ static void _enesim_renderer_pattern_argb8888_##rmode##_affine_span(		\
 	}									\
 }
 
+/* the pattern origin is on a pixel, so the tile rows are just copied */
+static void _enesim_renderer_pattern_argb8888_repeat_identity_copy_span(
+		Enesim_Renderer *r, int x, int y, int len, void *ddata)
+{
+	Enesim_Renderer_Pattern *thiz;
+	uint32_t *dst = ddata;
+	uint32_t *src;
+	int sx, sy;
+
+	thiz = ENESIM_RENDERER_PATTERN(r);
+	sx = (x - thiz->src_ox) % thiz->src_w;
+	if (sx < 0) sx += thiz->src_w;
+	sy = (y - thiz->src_oy) % thiz->src_h;
+	if (sy < 0) sy += thiz->src_h;
+	src = (uint32_t *)((uint8_t *)thiz->ssrc + (sy * thiz->sstride));
+	while (len)
+	{
+		int n = thiz->src_w - sx;
+
+		if (n > len) n = len;
+		memcpy(dst, src + sx, n * sizeof(uint32_t));
+		dst += n;
+		len -= n;
+		sx = 0;
+	}
+}
+
 PATTERN_IDENTITY(reflect)
 PATTERN_IDENTITY(repeat)
 
@@ -269,7 +302,8 @@ static Eina_Bool _pattern_sw_setup(Enesim_Renderer *r,
 	/* do the common setup */
 	if (!_pattern_state_setup(r, s, l))
 		return EINA_FALSE;
-	if (!enesim_surface_map(thiz->src, (void **)&thiz->ssrc, &thiz->sstride))
+	if (thiz->src && !enesim_surface_map(thiz->src, (void **)&thiz->ssrc,
+			&thiz->sstride))
 	{
 		_pattern_state_cleanup(r, s);
 		return EINA_FALSE;
@@ -281,6 +315,24 @@ static Eina_Bool _pattern_sw_setup(Enesim_Renderer *r,
 	type = enesim_renderer_transformation_type_get(r);
 	*fill = _spans[thiz->current.repeat_mode][type];
 
+	/* check if the pixels of the tile can be copied as they are */
+	if (type == ENESIM_MATRIX_TYPE_IDENTITY &&
+			thiz->current.repeat_mode == ENESIM_REPEAT_MODE_REPEAT)
+	{
+		double ox, oy;
+
+		enesim_renderer_origin_get(r, &ox, &oy);
+		if (!eina_f16p16_fracc_get(eina_f16p16_double_from(ox)) &&
+				!eina_f16p16_fracc_get(eina_f16p16_double_from(oy)))
+		{
+			thiz->src_ox = eina_f16p16_int_to(eina_f16p16_double_from(ox)) +
+					eina_f16p16_int_to(thiz->src_xx);
+			thiz->src_oy = eina_f16p16_int_to(eina_f16p16_double_from(oy)) +
+					eina_f16p16_int_to(thiz->src_yy);
+			*fill = _enesim_renderer_pattern_argb8888_repeat_identity_copy_span;
+		}
+	}
+
 	return EINA_TRUE;
 }
 
@@ -289,7 +341,8 @@ static void _pattern_sw_cleanup(Enesim_Renderer *r, Enesim_Surface *s)
 	Enesim_Renderer_Pattern *thiz;
 
 	thiz = ENESIM_RENDERER_PATTERN(r);
-	enesim_surface_unmap(thiz->src, (void **)&thiz->ssrc, EINA_FALSE);
+	if (thiz->src)
+		enesim_surface_unmap(thiz->src, (void **)&thiz->ssrc, EINA_FALSE);
 	_pattern_state_cleanup(r, s);
 }
 
@@ -356,8 +409,12 @@ static void _enesim_renderer_pattern_class_init(void *k)
 	_spans[ENESIM_REPEAT_MODE_RESTRICT][ENESIM_MATRIX_TYPE_AFFINE] = _enesim_renderer_pattern_argb8888_restrict_affine_span;
 }
 
-static void _enesim_renderer_pattern_instance_init(void *o EINA_UNUSED)
+static void _enesim_renderer_pattern_instance_init(void *o)
 {
+	Enesim_Renderer_Pattern *thiz;
+
+	thiz = ENESIM_RENDERER_PATTERN(o);
+	thiz->cache = enesim_draw_cache_new();
 }
 
 static void _enesim_renderer_pattern_instance_deinit(void *o)
@@ -372,7 +429,7 @@ static void _enesim_renderer_pattern_instance_deinit(void *o)
 	if (thiz->src)
 		enesim_surface_unref(thiz->src);
 	if (thiz->cache)
-		enesim_surface_unref(thiz->cache);
+		enesim_draw_cache_free(thiz->cache);
 }
 /** @endcond */
 /*============================================================================*
@@ -17,6 +17,9 @@
  */
 #include "enesim_private.h"
 
+#include <stdint.h>
+#include <limits.h>
+
 #include "enesim_main.h"
 #include "enesim_log.h"
 #include "enesim_color.h"
@@ -52,6 +55,13 @@ typedef struct _Enesim_Renderer_Perlin
 	} xfreq, yfreq, ampl;
 	double persistence;
 	int octaves;
+	/* the noise of a tile of pixels that repeats, precalculated */
+	struct {
+		unsigned int size;
+		uint8_t *data;
+		int *xperiods;
+		int *yperiods;
+	} tile;
 	Eina_Bool changed;
 } Enesim_Renderer_Perlin;
 
@@ -89,42 +99,140 @@ static void _perlin_fill_argb8888_affine(Enesim_Renderer *r, int x, int y, int l
 }
 #endif
 
+/* the perlin noise is on the -1,1 range, so we need to get it back to 0-255 */
+static inline uint8_t _perlin_gray_get(Eina_F16p16 per)
+{
+	int i;
+
+	per = eina_f16p16_mul(per, eina_f16p16_double_from(255));
+	per = eina_f16p16_add(per, eina_f16p16_double_from(255));
+	per = eina_f16p16_div(per, eina_f16p16_int_from(2));
+	/* it is still possible to be outside the range? */
+	i = eina_f16p16_int_to(per);
+	if (i < 0) i = 0;
+	else if (i > 255) i = 255;
+	return i;
+}
+
+static inline uint32_t _perlin_color_get(uint8_t i, Enesim_Color rcolor)
+{
+	Enesim_Color color;
+
+	color = 0xff << 24 | i << 16 | i << 8 | i;
+	if (rcolor != ENESIM_COLOR_FULL)
+		color = enesim_color_mul4_sym(color, rcolor);
+	return color;
+}
+
+/* calculate the noise of every row of the tile */
+static Eina_Bool _perlin_tile_generate(Enesim_Renderer_Perlin *thiz)
+{
+	Eina_F16p16 *row;
+	uint8_t *data;
+	size_t size = thiz->tile.size;
+	size_t x, y;
+
+	/* the rows are evaluated at 16.16 coordinates */
+	if (size > (INT_MAX >> 16) || size > SIZE_MAX / size)
+		return EINA_FALSE;
+	data = realloc(thiz->tile.data, size * size);
+	if (!data)
+		return EINA_FALSE;
+	thiz->tile.data = data;
+
+	free(thiz->tile.xperiods);
+	free(thiz->tile.yperiods);
+	thiz->tile.xperiods = malloc(sizeof(int) * thiz->octaves);
+	thiz->tile.yperiods = malloc(sizeof(int) * thiz->octaves);
+	if (thiz->octaves && (!thiz->tile.xperiods || !thiz->tile.yperiods))
+		goto err;
+	row = malloc(sizeof(Eina_F16p16) * size);
+	if (!row)
+		goto err;
+
+	enesim_perlin_tile_coeff_set(thiz->octaves, size, thiz->xfreq.coeff,
+			thiz->yfreq.coeff, thiz->tile.xperiods,
+			thiz->tile.yperiods);
+
+	for (y = 0; y < size; y++)
+	{
+		uint8_t *dst = thiz->tile.data + (y * size);
+
+		enesim_perlin_span_get(0, eina_f16p16_int_from(y), size,
+				thiz->octaves, thiz->xfreq.coeff,
+				thiz->yfreq.coeff, thiz->ampl.coeff,
+				thiz->tile.xperiods, thiz->tile.yperiods, row);
+		for (x = 0; x < size; x++)
+			dst[x] = _perlin_gray_get(row[x]);
+	}
+	free(row);
+	return EINA_TRUE;
+err:
+	free(thiz->tile.xperiods);
+	free(thiz->tile.yperiods);
+	thiz->tile.xperiods = NULL;
+	thiz->tile.yperiods = NULL;
+	return EINA_FALSE;
+}
+
+static void _perlin_tile_free(Enesim_Renderer_Perlin *thiz)
+{
+	free(thiz->tile.data);
+	free(thiz->tile.xperiods);
+	free(thiz->tile.yperiods);
+	thiz->tile.data = NULL;
+	thiz->tile.xperiods = NULL;
+	thiz->tile.yperiods = NULL;
+}
+
 static void _perlin_fill_argb8888_identity(Enesim_Renderer *r,
 		int x, int y, int len, void *ddata)
 {
 	Enesim_Renderer_Perlin *thiz;
 	Enesim_Color rcolor;
+	Eina_F16p16 *per = ddata;
 	uint32_t *dst = ddata;
 	uint32_t *end = dst + len;
-	Eina_F16p16 xx, yy;
 
 	thiz = ENESIM_RENDERER_PERLIN(r);
 	rcolor = r->state.current.color;
 	/* end of state setup */
-	xx = eina_f16p16_int_from(x);
-	yy = eina_f16p16_int_from(y);
+	/* the noise is calculated in place and then converted */
+	enesim_perlin_span_get(eina_f16p16_int_from(x), eina_f16p16_int_from(y),
+			len, thiz->octaves, thiz->xfreq.coeff,
+			thiz->yfreq.coeff, thiz->ampl.coeff, NULL, NULL, per);
 	while (dst < end)
 	{
-		Enesim_Color color;
-		Eina_F16p16 per;
-		int i;
+		*dst = _perlin_color_get(_perlin_gray_get(*per), rcolor);
+		dst++;
+		per++;
+	}
+}
 
-		per = enesim_perlin_get(xx, yy, thiz->octaves, thiz->xfreq.coeff,
-				thiz->yfreq.coeff, thiz->ampl.coeff);
-		/* the perlin noise is on the -1,1 range, so we need to get it back to 0-255 */
-		per = eina_f16p16_mul(per, eina_f16p16_double_from(255));
-		per = eina_f16p16_add(per, eina_f16p16_double_from(255));
-		per = eina_f16p16_div(per, eina_f16p16_int_from(2));
-		/* it is still possible to be outside the range? */
-		i = eina_f16p16_int_to(per);
-		if (i < 0) i = 0;
-		else if (i > 255) i = 255;
-		
-		color = 0xff << 24 | i << 16 | i << 8 | i;
-		if (rcolor != ENESIM_COLOR_FULL)
-			color = enesim_color_mul4_sym(color, rcolor);
-		*dst++ = color;
-		xx += 65536;
+static void _perlin_tile_fill_argb8888_identity(Enesim_Renderer *r,
+		int x, int y, int len, void *ddata)
+{
+	Enesim_Renderer_Perlin *thiz;
+	Enesim_Color rcolor;
+	uint32_t *dst = ddata;
+	uint32_t *end = dst + len;
+	uint8_t *row;
+	int size;
+
+	thiz = ENESIM_RENDERER_PERLIN(r);
+	rcolor = r->state.current.color;
+	size = thiz->tile.size;
+	/* end of state setup */
+	y %= size;
+	if (y < 0) y += size;
+	x %= size;
+	if (x < 0) x += size;
+	row = thiz->tile.data + ((size_t)y * size);
+	while (dst < end)
+	{
+		*dst++ = _perlin_color_get(row[x], rcolor);
+		if (++x == size)
+			x = 0;
 	}
 }
 /*----------------------------------------------------------------------------*
@@ -137,7 +245,7 @@ static const char * _perlin_name(Enesim_Renderer *r EINA_UNUSED)
 
 static Eina_Bool _perlin_sw_setup(Enesim_Renderer *r,
 		Enesim_Surface *s EINA_UNUSED, Enesim_Rop rop EINA_UNUSED,
-		Enesim_Renderer_Sw_Fill *fill, Enesim_Log **l EINA_UNUSED)
+		Enesim_Renderer_Sw_Fill *fill, Enesim_Log **l)
 {
 	Enesim_Renderer_Perlin *thiz;
 	Enesim_Matrix_Type type;
@@ -160,7 +268,26 @@ static Eina_Bool _perlin_sw_setup(Enesim_Renderer *r,
 	if (type != ENESIM_MATRIX_TYPE_IDENTITY)
 		return EINA_FALSE;
 
-	*fill = _perlin_fill_argb8888_identity;
+	if (thiz->tile.size)
+	{
+		/* the tile is kept between draws */
+		if (thiz->changed || !thiz->tile.data)
+		{
+			if (!_perlin_tile_generate(thiz))
+			{
+				ENESIM_RENDERER_LOG(r, l, "Impossible to generate "
+						"a tile of size %u", thiz->tile.size);
+				_perlin_tile_free(thiz);
+				return EINA_FALSE;
+			}
+		}
+		*fill = _perlin_tile_fill_argb8888_identity;
+	}
+	else
+	{
+		_perlin_tile_free(thiz);
+		*fill = _perlin_fill_argb8888_identity;
+	}
 	return EINA_TRUE;
 }
 
@@ -175,6 +302,9 @@ static void _perlin_sw_cleanup(Enesim_Renderer *r, Enesim_Surface *s EINA_UNUSED
 		free(thiz->yfreq.coeff);
 	if (thiz->ampl.coeff)
 		free(thiz->ampl.coeff);
+	thiz->xfreq.coeff = NULL;
+	thiz->yfreq.coeff = NULL;
+	thiz->ampl.coeff = NULL;
 	thiz->changed = EINA_FALSE;
 }
 
@@ -229,8 +359,11 @@ static void _enesim_renderer_perlin_instance_init(void *o)
 	thiz->persistence = 1;
 }
 
-static void _enesim_renderer_perlin_instance_deinit(void *o EINA_UNUSED)
+static void _enesim_renderer_perlin_instance_deinit(void *o)
 {
+	Enesim_Renderer_Perlin *thiz = ENESIM_RENDERER_PERLIN(o);
+
+	_perlin_tile_free(thiz);
 }
 /*============================================================================*
  *                                 Global                                     *
@@ -267,6 +400,7 @@ EAPI void enesim_renderer_perlin_octaves_set(Enesim_Renderer *r, unsigned int oc
 
 	thiz = ENESIM_RENDERER_PERLIN(r);
 	thiz->octaves = octaves;
+	thiz->changed = EINA_TRUE;
 }
 
 /**
@@ -284,6 +418,7 @@ EAPI void enesim_renderer_perlin_persistence_set(Enesim_Renderer *r, double pers
 
 	thiz = ENESIM_RENDERER_PERLIN(r);
 	thiz->persistence = persistence;
+	thiz->changed = EINA_TRUE;
 }
 
 /**
@@ -300,6 +435,7 @@ EAPI void enesim_renderer_perlin_amplitude_set(Enesim_Renderer *r, double ampl)
 
 	thiz = ENESIM_RENDERER_PERLIN(r);
 	thiz->ampl.val = ampl;
+	thiz->changed = EINA_TRUE;
 }
 
 /**
@@ -316,6 +452,7 @@ EAPI void enesim_renderer_perlin_xfrequency_set(Enesim_Renderer *r, double freq)
 
 	thiz = ENESIM_RENDERER_PERLIN(r);
 	thiz->xfreq.val = freq;
+	thiz->changed = EINA_TRUE;
 }
 
 /**
@@ -332,4 +469,28 @@ EAPI void enesim_renderer_perlin_yfrequency_set(Enesim_Renderer *r, double freq)
 
 	thiz = ENESIM_RENDERER_PERLIN(r);
 	thiz->yfreq.val = freq;
+	thiz->changed = EINA_TRUE;
+}
+
+/**
+ * @brief Set the size of the tile of the perlin noise renderer
+ * @ender_prop{tile_size}
+ * @param[in] r The perlin noise renderer
+ * @param[in] size The size in pixels of the tile, 0 to disable it
+ *
+ * When a tile size is set, the noise of a square tile of that size is
+ * calculated once and repeated on both axis. The tile is kept between draws
+ * until a property changes, which makes redrawing a noise background much
+ * faster. For the tile to be seamless the frequencies of every octave are
+ * rounded to fit an integer number of cycles on the tile.
+ */
+EAPI void enesim_renderer_perlin_tile_size_set(Enesim_Renderer *r, unsigned int size)
+{
+	Enesim_Renderer_Perlin *thiz;
+
+	thiz = ENESIM_RENDERER_PERLIN(r);
+	if (thiz->tile.size == size)
+		return;
+	thiz->tile.size = size;
+	thiz->changed = EINA_TRUE;
 }
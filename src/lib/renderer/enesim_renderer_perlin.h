@@ -35,6 +35,7 @@ EAPI void enesim_renderer_perlin_persistence_set(Enesim_Renderer *r, double pers
 EAPI void enesim_renderer_perlin_amplitude_set(Enesim_Renderer *r, double ampl);
 EAPI void enesim_renderer_perlin_xfrequency_set(Enesim_Renderer *r, double freq);
 EAPI void enesim_renderer_perlin_yfrequency_set(Enesim_Renderer *r, double freq);
+EAPI void enesim_renderer_perlin_tile_size_set(Enesim_Renderer *r, unsigned int size);
 
 /**
  * @}
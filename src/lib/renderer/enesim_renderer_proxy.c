@@ -149,6 +149,7 @@ static Eina_Bool _proxy_sw_setup(Enesim_Renderer *r,
 	{
 		*fill = _proxy_blend_or_equal_span;
 	}
+	enesim_renderer_sw_delegate_set(r, thiz->proxied);
 
 	return EINA_TRUE;
 }
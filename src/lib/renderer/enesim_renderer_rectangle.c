@@ -40,6 +40,7 @@
 #endif
 
 #include "enesim_list_private.h"
+#include "enesim_color_private.h"
 #include "enesim_renderer_private.h"
 #include "enesim_renderer_shape_private.h"
 #include "enesim_renderer_shape_path_private.h"
@@ -273,6 +274,64 @@ static const char * _rectangle_base_name_get(Enesim_Renderer *r EINA_UNUSED)
 {
 	return "rectangle";
 }
+
+static Eina_Bool _rectangle_opaque_bounds_get(Enesim_Renderer *r,
+		Eina_Rectangle *rect)
+{
+	Enesim_Renderer_Rectangle *thiz;
+	const Enesim_Renderer_Shape_State *sstate;
+	double ox, oy;
+	double x1, y1, x2, y2;
+	double ry;
+
+	thiz = ENESIM_RENDERER_RECTANGLE(r);
+	/* the path renderer does not handle the origin nor the transformation
+	 * on the opaque area
+	 */
+	if (enesim_renderer_transformation_type_get(r) != ENESIM_MATRIX_TYPE_IDENTITY)
+		return EINA_FALSE;
+	enesim_renderer_origin_get(r, &ox, &oy);
+	if (ox != 0 || oy != 0)
+		return EINA_FALSE;
+
+	sstate = enesim_renderer_shape_state_get(r);
+	if (!(sstate->current.draw_mode & ENESIM_RENDERER_SHAPE_DRAW_MODE_FILL))
+		return EINA_FALSE;
+	if (sstate->current.fill.r)
+		return EINA_FALSE;
+	if (enesim_color_alpha_get(sstate->current.fill.color) != 0xff)
+		return EINA_FALSE;
+	/* whatever the location of the stroke is, the fill and the stroke
+	 * together always cover the geometry
+	 */
+	if (sstate->current.draw_mode & ENESIM_RENDERER_SHAPE_DRAW_MODE_STROKE)
+	{
+		if (sstate->current.stroke.r)
+			return EINA_FALSE;
+		if (enesim_color_alpha_get(sstate->current.stroke.color) != 0xff)
+			return EINA_FALSE;
+	}
+
+	x1 = thiz->current.x;
+	y1 = thiz->current.y;
+	x2 = x1 + thiz->current.width;
+	y2 = y1 + thiz->current.height;
+	/* skip the rows of the rounded corners */
+	ry = thiz->current.corner.ry;
+	if (ry > thiz->current.height / 2.0)
+		ry = thiz->current.height / 2.0;
+	if ((thiz->current.corner.tl || thiz->current.corner.tr ||
+			thiz->current.corner.bl || thiz->current.corner.br) &&
+			thiz->current.corner.rx > 0 && ry > 0)
+	{
+		y1 += ry;
+		y2 -= ry;
+	}
+	/* keep one pixel away from the antialiased edges */
+	eina_rectangle_coords_from(rect, ceil(x1) + 1, ceil(y1) + 1,
+			floor(x2) - ceil(x1) - 2, floor(y2) - ceil(y1) - 2);
+	return eina_rectangle_is_valid(rect);
+}
 /*----------------------------------------------------------------------------*
  *                            Object definition                               *
  *----------------------------------------------------------------------------*/
@@ -288,6 +347,7 @@ static void _enesim_renderer_rectangle_class_init(void *k)
 
 	r_klass = ENESIM_RENDERER_CLASS(k);
 	r_klass->base_name_get = _rectangle_base_name_get;
+	r_klass->opaque_bounds_get = _rectangle_opaque_bounds_get;
 
 	s_klass = ENESIM_RENDERER_SHAPE_CLASS(k);
 	s_klass->features_get = _rectangle_shape_features_get;
@@ -143,9 +143,13 @@ static Eina_Bool _shape_path_sw_setup(Enesim_Renderer *r,
 		Enesim_Surface *s, Enesim_Rop rop,
 		Enesim_Renderer_Sw_Fill *draw, Enesim_Log **l)
 {
+	Enesim_Renderer_Shape_Path *thiz;
+
 	if (!_shape_path_setup(r, s, rop, l))
 		return EINA_FALSE;
+	thiz = ENESIM_RENDERER_SHAPE_PATH(r);
 	*draw = _shape_path_path_span;
+	enesim_renderer_sw_delegate_set(r, thiz->r_path);
 	return EINA_TRUE;
 }
 
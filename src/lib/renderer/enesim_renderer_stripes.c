@@ -42,6 +42,7 @@
 #endif
 
 #include "enesim_color_private.h"
+#include "enesim_color_fill_private.h"
 #include "enesim_coord_private.h"
 #include "enesim_renderer_private.h"
 #include "enesim_surface_private.h"
@@ -74,6 +75,8 @@ typedef struct _Enesim_Renderer_Stripes {
 	Enesim_Matrix_F16p16 matrix;
 	double ox;
 	double oy;
+	/* every row has a single color */
+	Eina_Bool do_runs;
 } Enesim_Renderer_Stripes;
 
 typedef struct _Enesim_Renderer_Stripes_Class {
@@ -310,15 +313,58 @@ static void _span_projective_paints(Enesim_Renderer *r,
 	}
 }
 
+static inline uint32_t _stripes_color_get(Enesim_Renderer_Stripes *thiz,
+		Eina_F16p16 yy)
+{
+	Eina_F16p16 hh = thiz->hh, hh0 = thiz->hh0, h0 = eina_f16p16_int_to(hh0);
+	Enesim_Color c0 = thiz->final_color1;
+	Enesim_Color c1 = thiz->final_color2;
+	uint32_t p0 = c0;
+	int syy = (yy % hh), sy;
+
+	if (syy < 0)
+		syy += hh;
+	sy = syy >> 16;
+	if (sy == 0)
+	{
+		int a = 1 + ((syy & 0xffff) >> 8);
+
+		p0 = enesim_color_interp_256(a, c0, c1);
+	}
+	if (syy >= hh0)
+	{
+		p0 = c1;
+		if (sy == h0)
+		{
+			int a = 1 + ((syy & 0xffff) >> 8);
+
+			p0 = enesim_color_interp_256(a, c1, c0);
+		}
+	}
+	return p0;
+}
+
+/* the stripes only depend on the y coordinate, in case the transformation
+ * does not make it depend on x too, the whole span has the same color
+ */
+static void _span_axis_aligned(Enesim_Renderer *r,
+		int x, int y,
+		int len, void *ddata)
+{
+	Enesim_Renderer_Stripes *thiz = ENESIM_RENDERER_STRIPES(r);
+	Eina_F16p16 yy, xx;
+
+	enesim_coord_affine_setup(&xx, &yy, x, y, thiz->ox, thiz->oy,  &thiz->matrix);
+	enesim_color_fill_sp_none_color_none(ddata, len,
+			_stripes_color_get(thiz, yy));
+}
+
 static void _span_affine(Enesim_Renderer *r,
 		int x, int y,
 		int len, void *ddata)
 {
 	Enesim_Renderer_Stripes *thiz = ENESIM_RENDERER_STRIPES(r);
 	Eina_F16p16 ayx = thiz->matrix.yx;
-	Eina_F16p16 hh = thiz->hh, hh0 = thiz->hh0, h0 = eina_f16p16_int_to(hh0);
-	Enesim_Color c0 = thiz->final_color1;
-	Enesim_Color c1 = thiz->final_color2;
 	uint32_t *dst = ddata;
 	uint32_t *d = dst, *e = d + len;
 	Eina_F16p16 yy, xx;
@@ -326,33 +372,26 @@ static void _span_affine(Enesim_Renderer *r,
 	enesim_coord_affine_setup(&xx, &yy, x, y, thiz->ox, thiz->oy,  &thiz->matrix);
 	while (d < e)
 	{
-		uint32_t p0 = c0;
-		int syy = (yy % hh), sy;
-
-		if (syy < 0)
-			syy += hh;
-		sy = syy >> 16;
-		if (sy == 0)
-		{
-			int a = 1 + ((syy & 0xffff) >> 8);
-
-			p0 = enesim_color_interp_256(a, c0, c1);
-		}
-		if (syy >= hh0)
-		{
-			p0 = c1;
-			if (sy == h0)
-			{
-				int a = 1 + ((syy & 0xffff) >> 8);
-
-				p0 = enesim_color_interp_256(a, c1, c0);
-			}
-		}
-		*d++ = p0;
+		*d++ = _stripes_color_get(thiz, yy);
 		yy += ayx;
 	}
 }
 
+static int _stripes_sw_runs_get(Enesim_Renderer *r, int x, int y, int len,
+		Enesim_Renderer_Sw_Run *runs, int max)
+{
+	Enesim_Renderer_Stripes *thiz = ENESIM_RENDERER_STRIPES(r);
+	Eina_F16p16 yy, xx;
+
+	if (!thiz->do_runs || max < 1)
+		return 0;
+	enesim_coord_affine_setup(&xx, &yy, x, y, thiz->ox, thiz->oy,  &thiz->matrix);
+	runs[0].len = len;
+	runs[0].color = _stripes_color_get(thiz, yy);
+	runs[0].solid = EINA_TRUE;
+	return 1;
+}
+
 static void _span_affine_paints(Enesim_Renderer *r,
 		int x, int y, int len, void *ddata)
 {
@@ -511,6 +550,11 @@ static Eina_Bool _stripes_sw_setup(Enesim_Renderer *r,
 		*fill = _span_affine;
 		if (thiz->current.even.paint || thiz->current.odd.paint)
 			*fill = _span_affine_paints;
+		else if (!thiz->matrix.yx)
+		{
+			*fill = _span_axis_aligned;
+			thiz->do_runs = EINA_TRUE;
+		}
 		break;
 
 		case ENESIM_MATRIX_TYPE_PROJECTIVE:
@@ -530,6 +574,7 @@ static void _stripes_sw_cleanup(Enesim_Renderer *r, Enesim_Surface *s)
 	Enesim_Renderer_Stripes *thiz;
 
 	thiz = ENESIM_RENDERER_STRIPES(r);
+	thiz->do_runs = EINA_FALSE;
 	_stripes_state_cleanup(thiz, s);
 }
 
@@ -708,6 +753,7 @@ static void _enesim_renderer_stripes_class_init(void *k)
 	klass->sw_hints_get = _stripes_sw_hints;
 	klass->sw_setup = _stripes_sw_setup;
 	klass->sw_cleanup = _stripes_sw_cleanup;
+	klass->sw_runs_get = _stripes_sw_runs_get;
 #if BUILD_OPENCL
 	klass->opencl_kernel_get = _stripes_opencl_kernel_get;
 	klass->opencl_kernel_setup = _stripes_opencl_kernel_setup;
@@ -46,6 +46,7 @@
 #include "enesim_text_private.h"
 #include "enesim_list_private.h"
 #include "enesim_coord_private.h"
+#include "enesim_path_private.h"
 #include "enesim_renderer_private.h"
 #include "enesim_renderer_shape_private.h"
 
@@ -93,6 +94,24 @@ typedef struct _Enesim_Renderer_Text_Span_State
 	Eina_Bool had_changed : 1;
 } Enesim_Renderer_Text_Span_State;
 
+/* every character of the text buffer has one of these */
+typedef struct _Enesim_Renderer_Text_Span_Glyph
+{
+	Enesim_Text_Glyph *g;
+	/* on image mode, the glyph drawn when the glyph is placed at a
+	 * subpixel position
+	 */
+	Enesim_Text_Glyph *variant;
+	/* the subpixel variants that failed to load, as bits */
+	int failed;
+	/* the layer is owned by the compound */
+	Enesim_Renderer_Compound_Layer *layer;
+	Enesim_Renderer *r;
+	/* the offset of the glyph, kerning included */
+	double ox;
+	double kern;
+} Enesim_Renderer_Text_Span_Glyph;
+
 typedef struct _Enesim_Renderer_Text_Span
 {
 	Enesim_Renderer_Shape parent;
@@ -101,21 +120,18 @@ typedef struct _Enesim_Renderer_Text_Span
 	Enesim_Renderer *compound;
 	Enesim_Renderer_Text_Span_Glyph_Mode mode;
 	Enesim_Rectangle geometry;
+	Enesim_Renderer_Text_Span_Glyph *glyphs;
+	int nglyphs;
+	int aglyphs;
+	/* on path mode every glyph outline is merged on a single path */
+	Enesim_Renderer *path_r;
+	Enesim_Path *path;
 } Enesim_Renderer_Text_Span;
 
 typedef struct _Enesim_Renderer_Text_Span_Class {
 	Enesim_Renderer_Shape_Class parent;
 } Enesim_Renderer_Text_Span_Class;
 
-typedef struct _Enesim_Renderer_Text_Span_Propagate_Cb_Data
-{
-	Enesim_Renderer *r;
-	Enesim_Text_Glyph *prev;
-	int idx;
-	double ox;
-	Eina_Bool has_kerning;
-} Enesim_Renderer_Text_Span_Propagate_Cb_Data;
-
 static void _enesim_renderer_text_span_glyph_propagate(Enesim_Renderer *r,
 		Enesim_Renderer *glyph, double ox, double oy)
 {
@@ -140,49 +156,432 @@ static void _enesim_renderer_text_span_glyph_propagate(Enesim_Renderer *r,
 		enesim_renderer_color_set(glyph, fill_color);
 	}
 	enesim_renderer_transformation_get(r, &m);
+	/* without a transformation the glyph image is just copied */
+	if (thiz->mode == ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE &&
+			enesim_renderer_transformation_type_get(r) == ENESIM_MATRIX_TYPE_IDENTITY)
+	{
+		enesim_matrix_identity(&tx);
+		enesim_renderer_transformation_set(glyph, &tx);
+		enesim_renderer_image_position_set(glyph, ox, oy);
+		return;
+	}
+	if (thiz->mode == ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE)
+		enesim_renderer_image_position_set(glyph, 0, 0);
 	enesim_matrix_translate(&tx, ox, oy);
 	enesim_matrix_compose(&m, &tx, &tx);
 	enesim_renderer_transformation_set(glyph, &tx);
 }
 
-static Eina_Bool _enesim_renderer_text_span_propagate_cb(
-		Enesim_Renderer *c EINA_UNUSED,
-		Enesim_Renderer_Compound_Layer *layer, void *data)
+/* Use the glyph rasterized at the subpixel position on the image renderer
+ * of a glyph. In case the variant can not be loaded, the glyph at the pixel
+ * position is used and the variant is not tried again. The surface of the
+ * glyph at the pixel position might have been released by the font, so it
+ * is loaded again only when it is used
+ */
+static void _enesim_renderer_text_span_glyph_variant_set(Enesim_Renderer_Text_Span *thiz,
+		Enesim_Renderer_Text_Span_Glyph *glyph, int subpixel)
 {
-	Enesim_Renderer_Text_Span *thiz;
-	Enesim_Renderer_Text_Span_Propagate_Cb_Data *cb_data = data;
-	Enesim_Renderer *rl;
-	Enesim_Text_Glyph *g = NULL;
+	Enesim_Text_Glyph *variant = NULL;
+	Enesim_Text_Glyph *g;
+	int w, h;
+
+	if (glyph->failed & (1 << subpixel))
+		subpixel = 0;
+	if (subpixel == (glyph->variant ? glyph->variant->subpixel : 0))
+		return;
+	if (subpixel)
+	{
+		variant = enesim_text_font_glyph_variant_get(
+				thiz->state.current.font, glyph->g->code, subpixel);
+		if (variant)
+		{
+			enesim_text_glyph_cache(enesim_text_glyph_ref(variant));
+			if (!enesim_text_glyph_load(variant,
+					ENESIM_TEXT_GLYPH_FORMAT_SURFACE) ||
+					!variant->surface)
+			{
+				enesim_text_glyph_unref(variant);
+				variant = NULL;
+			}
+		}
+		if (!variant)
+			glyph->failed |= 1 << subpixel;
+	}
+	if (glyph->variant)
+		enesim_text_glyph_unref(glyph->variant);
+	glyph->variant = variant;
+
+	g = variant ? variant : glyph->g;
+	if (!variant && (!enesim_text_glyph_load(g,
+			ENESIM_TEXT_GLYPH_FORMAT_SURFACE) || !g->surface))
+	{
+		enesim_renderer_image_source_surface_set(glyph->r, NULL);
+		return;
+	}
+	enesim_surface_size_get(g->surface, &w, &h);
+	enesim_renderer_image_size_set(glyph->r, w, h);
+	enesim_renderer_image_source_surface_set(glyph->r,
+			enesim_surface_ref(g->surface));
+}
+
+/* Place the image of a glyph. Without a transformation the glyph is placed
+ * on a pixel position and the fractional part is quantized to one of the
+ * subpixel variants, that way the glyph is not resampled when drawn
+ */
+static void _enesim_renderer_text_span_glyph_place(Enesim_Renderer_Text_Span *thiz,
+		Enesim_Renderer_Text_Span_Glyph *glyph, double x, double y)
+{
+	Enesim_Renderer *r;
+	int subpixel = 0;
+
+	r = ENESIM_RENDERER(thiz);
+	if (enesim_renderer_transformation_type_get(r) == ENESIM_MATRIX_TYPE_IDENTITY)
+	{
+		double ix;
+
+		ix = floor(x);
+		subpixel = (int)((x - ix) * ENESIM_TEXT_GLYPH_SUBPIXELS + 0.5);
+		if (subpixel == ENESIM_TEXT_GLYPH_SUBPIXELS)
+		{
+			subpixel = 0;
+			ix++;
+		}
+		x = ix;
+		y = floor(y + 0.5);
+	}
+	_enesim_renderer_text_span_glyph_variant_set(thiz, glyph, subpixel);
+	_enesim_renderer_text_span_glyph_propagate(r, glyph->r, x, y);
+}
+
+static void _enesim_renderer_text_span_glyph_clear(Enesim_Renderer_Text_Span *thiz,
+		Enesim_Renderer_Text_Span_Glyph *glyph, Eina_Bool remove)
+{
+	if (glyph->layer && remove)
+	{
+		/* the remove takes the reference we give */
+		enesim_renderer_compound_layer_remove(thiz->compound,
+				enesim_renderer_compound_layer_ref(glyph->layer));
+	}
+	glyph->layer = NULL;
+	glyph->r = NULL;
+	if (glyph->variant)
+	{
+		enesim_text_glyph_unref(glyph->variant);
+		glyph->variant = NULL;
+	}
+	if (glyph->g)
+	{
+		enesim_text_glyph_unref(glyph->g);
+		glyph->g = NULL;
+	}
+}
+
+static void _enesim_renderer_text_span_glyphs_clear(Enesim_Renderer_Text_Span *thiz)
+{
+	int i;
+
+	/* the layers are removed all at once */
+	for (i = 0; i < thiz->nglyphs; i++)
+		_enesim_renderer_text_span_glyph_clear(thiz, &thiz->glyphs[i],
+				EINA_FALSE);
+	enesim_renderer_compound_layer_clear(thiz->compound);
+	thiz->nglyphs = 0;
+	/* the renderer is owned by its layer */
+	thiz->path_r = NULL;
+	if (thiz->path)
+	{
+		enesim_path_unref(thiz->path);
+		thiz->path = NULL;
+	}
+}
+
+static void _enesim_renderer_text_span_glyphs_resize(Enesim_Renderer_Text_Span *thiz,
+		int nglyphs)
+{
+	if (nglyphs > thiz->aglyphs)
+	{
+		int aglyphs = thiz->aglyphs ? thiz->aglyphs : 16;
+
+		while (aglyphs < nglyphs)
+			aglyphs *= 2;
+		thiz->glyphs = realloc(thiz->glyphs,
+				aglyphs * sizeof(Enesim_Renderer_Text_Span_Glyph));
+		thiz->aglyphs = aglyphs;
+	}
+	thiz->nglyphs = nglyphs;
+}
+
+static inline int _enesim_renderer_text_span_glyph_format_get(
+		Enesim_Renderer_Text_Span *thiz)
+{
+	/* load only the format we need */
+	if (thiz->mode == ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE)
+		return ENESIM_TEXT_GLYPH_FORMAT_SURFACE;
+	else
+		return ENESIM_TEXT_GLYPH_FORMAT_PATH;
+}
+
+/* get and cache the glyph, the same glyph is then found for the next
+ * characters
+ */
+static void _enesim_renderer_text_span_glyph_prepare(Enesim_Renderer_Text_Span *thiz,
+		Enesim_Renderer_Text_Span_Glyph *glyph, Eina_Unicode unicode)
+{
+	Enesim_Text_Glyph *g;
+
+	glyph->g = NULL;
+	glyph->variant = NULL;
+	glyph->failed = 0;
+	glyph->layer = NULL;
+	glyph->r = NULL;
+	glyph->ox = 0;
+	glyph->kern = 0;
+
+	g = enesim_text_font_glyph_get(thiz->state.current.font, unicode);
+	if (!g) return;
+	enesim_text_glyph_cache(enesim_text_glyph_ref(g));
+	glyph->g = g;
+}
+
+/* create the renderer and the layer of a glyph, the position is set later.
+ * On path mode the glyphs do not have a renderer, their outlines are merged
+ */
+static void _enesim_renderer_text_span_glyph_setup(Enesim_Renderer_Text_Span *thiz,
+		Enesim_Renderer_Text_Span_Glyph *glyph)
+{
+	Enesim_Text_Glyph *g = glyph->g;
+	Enesim_Renderer *i;
+	Enesim_Renderer_Compound_Layer *l;
+	int w, h;
+
+	if (!g) return;
+	if (!enesim_text_glyph_load(g, _enesim_renderer_text_span_glyph_format_get(thiz)))
+	{
+		enesim_text_glyph_unref(g);
+		glyph->g = NULL;
+		return;
+	}
+
+	if (thiz->mode != ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE || !g->surface)
+		return;
+
+	i = enesim_renderer_image_new();
+	enesim_surface_size_get(g->surface, &w, &h);
+	enesim_renderer_image_size_set(i, w, h);
+	enesim_renderer_image_source_surface_set(i,
+			enesim_surface_ref(g->surface));
+
+	/* add the new layer */
+	l = enesim_renderer_compound_layer_new();
+	enesim_renderer_compound_layer_renderer_set(l, i);
+	enesim_renderer_compound_layer_rop_set(l, ENESIM_ROP_BLEND);
+	enesim_renderer_compound_layer_add(thiz->compound, l);
+	glyph->layer = l;
+	glyph->r = i;
+}
+
+/* Setup the prepared glyphs in the [from, to) range. The missing glyphs
+ * are loaded all at once first, so the font can load them in parallel
+ */
+static void _enesim_renderer_text_span_glyphs_setup(Enesim_Renderer_Text_Span *thiz,
+		int from, int to)
+{
+	Enesim_Text_Glyph **glyphs;
+	int i;
+
+	/* in case the allocation fails the glyphs are loaded one by one */
+	if (to - from >= ENESIM_TEXT_FONT_GLYPHS_PARALLEL_THRESHOLD &&
+			(glyphs = malloc((to - from) * sizeof(Enesim_Text_Glyph *))))
+	{
+		for (i = from; i < to; i++)
+			glyphs[i - from] = thiz->glyphs[i].g;
+		enesim_text_font_glyphs_load(thiz->state.current.font, glyphs,
+				to - from, _enesim_renderer_text_span_glyph_format_get(thiz));
+		free(glyphs);
+	}
+	for (i = from; i < to; i++)
+		_enesim_renderer_text_span_glyph_setup(thiz, &thiz->glyphs[i]);
+}
+
+/* merge every glyph outline at its offset on the single path, the span
+ * position is set through the transformation of the path renderer
+ */
+static void _enesim_renderer_text_span_path_merge(Enesim_Renderer_Text_Span *thiz)
+{
+	int i;
+
+	enesim_path_command_clear(thiz->path);
+	for (i = 0; i < thiz->nglyphs; i++)
+	{
+		Enesim_Renderer_Text_Span_Glyph *glyph = &thiz->glyphs[i];
+
+		if (!glyph->g || !glyph->g->path)
+			continue;
+		enesim_path_translated_add(thiz->path, glyph->g->path,
+				glyph->ox, -glyph->g->origin);
+	}
+}
+
+/* Place the glyphs. The kerning of the glyphs in the [from, to) range is
+ * calculated again and those glyphs are always propagated. The rest of the
+ * glyphs are only propagated if their position has changed, unless force
+ * is set. On path mode the outlines are merged again whenever a glyph
+ * has changed or moved
+ */
+static void _enesim_renderer_text_span_glyphs_layout(Enesim_Renderer_Text_Span *thiz,
+		int from, int to, Eina_Bool force)
+{
+	Enesim_Renderer *r;
+	Enesim_Text_Glyph *prev = NULL;
+	Eina_Bool has_kerning;
+	Eina_Bool kern_pending = EINA_FALSE;
+	Eina_Bool merge = (from < to);
+	double ox = 0;
+	int i;
+
+	r = ENESIM_RENDERER(thiz);
+	has_kerning = enesim_text_font_has_kerning(thiz->state.current.font);
+	for (i = 0; i < thiz->nglyphs; i++)
+	{
+		Enesim_Renderer_Text_Span_Glyph *glyph = &thiz->glyphs[i];
+		Eina_Bool dirty = (i >= from && i < to);
+		double pos;
+
+		if (!glyph->g)
+		{
+			/* the glyph after this one has a new previous glyph */
+			if (dirty) kern_pending = EINA_TRUE;
+			continue;
+		}
+		if (dirty || kern_pending)
+		{
+			glyph->kern = has_kerning ?
+					enesim_text_glyph_kerning_get(glyph->g, prev) : 0;
+			kern_pending = dirty;
+		}
+		pos = ox + glyph->kern;
+		if (pos != glyph->ox)
+			merge = EINA_TRUE;
+		if (glyph->r && (force || dirty || pos != glyph->ox))
+		{
+			_enesim_renderer_text_span_glyph_place(thiz, glyph,
+					thiz->state.current.x + pos,
+					thiz->state.current.y - glyph->g->origin);
+		}
+		glyph->ox = pos;
+		ox += glyph->g->x_advance + glyph->kern;
+		prev = glyph->g;
+	}
+	if (thiz->path_r)
+	{
+		if (merge)
+			_enesim_renderer_text_span_path_merge(thiz);
+		if (merge || force)
+			_enesim_renderer_text_span_glyph_propagate(r,
+					thiz->path_r, thiz->state.current.x,
+					thiz->state.current.y);
+	}
+	enesim_rectangle_coords_from(&thiz->geometry,
+			thiz->state.current.x, thiz->state.current.y,
+			ox,
+			enesim_text_font_max_ascent_get(thiz->state.current.font) +
+			enesim_text_font_max_descent_get(thiz->state.current.font));
+}
+
+static void _enesim_renderer_text_span_glyphs_build(Enesim_Renderer_Text_Span *thiz)
+{
+	Eina_Unicode unicode;
 	const char *text;
-	double kern = 0;
+	int iidx = 0;
 
-	thiz = ENESIM_RENDERER_TEXT_SPAN(cb_data->r);
-	rl = enesim_renderer_compound_layer_renderer_get(layer);
+	_enesim_renderer_text_span_glyphs_clear(thiz);
+	if (thiz->mode == ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_PATH)
+	{
+		Enesim_Renderer_Compound_Layer *l;
+
+		thiz->path = enesim_path_new();
+		thiz->path_r = enesim_renderer_path_new();
+		enesim_renderer_path_inner_path_set(thiz->path_r,
+				enesim_path_ref(thiz->path));
+		l = enesim_renderer_compound_layer_new();
+		enesim_renderer_compound_layer_renderer_set(l, thiz->path_r);
+		enesim_renderer_compound_layer_rop_set(l, ENESIM_ROP_BLEND);
+		enesim_renderer_compound_layer_add(thiz->compound, l);
+	}
 	text = enesim_text_buffer_string_get(thiz->state.buffer);
-	while (!g)
+	if (!text) return;
+	while ((unicode = eina_unicode_utf8_next_get(text, &iidx)))
 	{
-		Eina_Unicode unicode;
+		int n = thiz->nglyphs;
 
-		unicode = eina_unicode_utf8_next_get(text, &cb_data->idx);
-		g = enesim_text_font_glyph_get(thiz->state.current.font, unicode);
-		if (cb_data->has_kerning)
-			kern = enesim_text_glyph_kerning_get(g, cb_data->prev);
-		if (!g->surface || !g->path)
+		_enesim_renderer_text_span_glyphs_resize(thiz, n + 1);
+		_enesim_renderer_text_span_glyph_prepare(thiz, &thiz->glyphs[n],
+				unicode);
+	}
+	_enesim_renderer_text_span_glyphs_setup(thiz, 0, thiz->nglyphs);
+}
+
+/* Only generate the glyphs of the characters that have been inserted or
+ * deleted since the last generation, the rest of the glyphs keep their
+ * renderers and are just moved
+ */
+static Eina_Bool _enesim_renderer_text_span_glyphs_update(Enesim_Renderer_Text_Span *thiz,
+		int *from, int *to)
+{
+	Eina_Unicode unicode;
+	const char *text;
+	int start, end, delta;
+	int oend;
+	int tail;
+	int iidx = 0;
+	int i;
+
+	if (!enesim_text_buffer_smart_dirty_range_get(thiz->state.buffer,
+			&start, &end, &delta))
+		return EINA_FALSE;
+	/* the range must match the glyphs we have */
+	oend = end - delta;
+	if (start < 0 || start > end || oend < start || oend > thiz->nglyphs)
+		return EINA_FALSE;
+	if (enesim_text_buffer_length_get(thiz->state.buffer) != thiz->nglyphs + delta)
+		return EINA_FALSE;
+	text = enesim_text_buffer_string_get(thiz->state.buffer);
+	if (!text) return EINA_FALSE;
+	/* find the first changed character */
+	for (i = 0; i < start; i++)
+	{
+		if (!eina_unicode_utf8_next_get(text, &iidx))
+			return EINA_FALSE;
+	}
+
+	/* remove the old glyphs and move the unchanged ones */
+	for (i = start; i < oend; i++)
+		_enesim_renderer_text_span_glyph_clear(thiz, &thiz->glyphs[i],
+				EINA_TRUE);
+	tail = thiz->nglyphs - oend;
+	_enesim_renderer_text_span_glyphs_resize(thiz, thiz->nglyphs + delta);
+	memmove(&thiz->glyphs[end], &thiz->glyphs[oend],
+			tail * sizeof(Enesim_Renderer_Text_Span_Glyph));
+
+	/* generate the new glyphs */
+	for (i = start; i < end; i++)
+	{
+		unicode = eina_unicode_utf8_next_get(text, &iidx);
+		if (!unicode)
 		{
-			cb_data->ox += g->x_advance + kern;
-			enesim_text_glyph_unref(cb_data->prev);
-			cb_data->prev = g;
-			g = NULL;
+			/* keep the array consistent before regenerating everything */
+			for (; i < end; i++)
+				memset(&thiz->glyphs[i], 0,
+						sizeof(Enesim_Renderer_Text_Span_Glyph));
+			return EINA_FALSE;
 		}
+		_enesim_renderer_text_span_glyph_prepare(thiz, &thiz->glyphs[i],
+				unicode);
 	}
-	_enesim_renderer_text_span_glyph_propagate(cb_data->r, rl,
-			thiz->state.current.x + cb_data->ox + kern,
-			thiz->state.current.y - g->origin);
-	cb_data->ox += g->x_advance + kern;
-	enesim_text_glyph_unref(cb_data->prev);
-	cb_data->prev = g;
-	enesim_renderer_unref(rl);
-
+	_enesim_renderer_text_span_glyphs_setup(thiz, start, end);
+	/* the glyph after the range has a new previous glyph */
+	*from = start;
+	*to = end + 1;
 	return EINA_TRUE;
 }
 
@@ -215,10 +614,6 @@ static Eina_Bool _enesim_renderer_text_span_glyphs_generate(Enesim_Renderer_Text
 	Eina_Bool r_changed = EINA_FALSE;
 	Eina_Bool s_changed = EINA_FALSE;
 	Eina_Bool glyphs_generated = EINA_TRUE;
-	Eina_Unicode unicode;
-	int iidx = 0;
-	const char *text;
-	double ox = 0;
 
 	/* commit the state */
 	if (thiz->state.changed)
@@ -283,87 +678,40 @@ static Eina_Bool _enesim_renderer_text_span_glyphs_generate(Enesim_Renderer_Text
 	if (enesim_text_buffer_smart_is_dirty(thiz->state.buffer) ||
 			!glyphs_generated)
 	{
+		Enesim_Renderer_Text_Span_Glyph_Mode mode;
 		Enesim_Renderer *fr;
-		Enesim_Text_Glyph *prev = NULL;
-		Eina_Bool has_kerning;
+		int from = 0;
+		int to = 0;
 
 		/* define the mode */
 		fr = enesim_renderer_shape_fill_renderer_get(r);
 		if (enesim_renderer_shape_draw_mode_get(r) & ENESIM_RENDERER_SHAPE_DRAW_MODE_STROKE)
 		{
-			thiz->mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_PATH;
+			mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_PATH;
 		}
 		else if (fr)
 		{
-			thiz->mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_PATH;
+			mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_PATH;
 		}
 		else
 		{
-			thiz->mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE;
+			mode = ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE;
 		}
 		enesim_renderer_unref(fr);
-		/* regenerate the glyphs */
-		has_kerning = enesim_text_font_has_kerning(thiz->state.current.font);
-		enesim_renderer_compound_layer_clear(thiz->compound);
-		text = enesim_text_buffer_string_get(thiz->state.buffer);
-		while ((unicode = eina_unicode_utf8_next_get(text, &iidx)))
-		{
-			Enesim_Text_Glyph *g;
+		if (mode != thiz->mode)
+			glyphs_generated = EINA_FALSE;
+		thiz->mode = mode;
 
-			g = enesim_text_font_glyph_get(thiz->state.current.font, unicode);
-			if (g)
-			{
-				Enesim_Renderer *i;
-				Enesim_Renderer_Compound_Layer *l;
-				double kern = 0;
-
-				/* load and cache the glyph */
-				if (!enesim_text_glyph_load(g, ENESIM_TEXT_GLYPH_FORMAT_SURFACE | ENESIM_TEXT_GLYPH_FORMAT_PATH))
-					continue;
-				enesim_text_glyph_cache(enesim_text_glyph_ref(g));
-				if (has_kerning)
-					kern = enesim_text_glyph_kerning_get(g, prev);
-
-				if (!g->surface || !g->path)
-					goto next;
-
-				if (thiz->mode == ENESIM_RENDERER_TEXT_SPAN_GLYPH_MODE_IMAGE)
-				{
-					int w, h;
-
-					i = enesim_renderer_image_new();
-					enesim_surface_size_get(g->surface, &w, &h);
-					enesim_renderer_image_size_set(i, w, h);
-					enesim_renderer_image_source_surface_set(i,
-							enesim_surface_ref(g->surface));
-				}
-				else
-				{
-					i = enesim_renderer_path_new();
-					enesim_renderer_path_inner_path_set(i, enesim_path_ref(g->path));
-				}
-
-				_enesim_renderer_text_span_glyph_propagate(r, i,
-						thiz->state.current.x + ox + kern,
-						thiz->state.current.y - g->origin);
-
-				/* add the new layer */
-				l = enesim_renderer_compound_layer_new();
-				enesim_renderer_compound_layer_renderer_set(l, i);
-				enesim_renderer_compound_layer_rop_set(l, ENESIM_ROP_BLEND);
-				enesim_renderer_compound_layer_add(thiz->compound, l);
-next:
-				ox += g->x_advance + kern;
-				enesim_text_glyph_unref(prev);
-				prev = g;
-			}
+		/* on a text edit only regenerate the edited glyphs */
+		if (!glyphs_generated || !_enesim_renderer_text_span_glyphs_update(
+				thiz, &from, &to))
+		{
+			_enesim_renderer_text_span_glyphs_build(thiz);
+			from = 0;
+			to = thiz->nglyphs;
 		}
-		enesim_text_glyph_unref(prev);
-		enesim_rectangle_coords_from(&thiz->geometry,
-				thiz->state.current.x, thiz->state.current.y,
-				ox,
-				enesim_text_font_max_ascent_get(thiz->state.current.font) +
-				enesim_text_font_max_descent_get(thiz->state.current.font));
+		_enesim_renderer_text_span_glyphs_layout(thiz, from, to,
+				r_changed || s_changed || thiz->state.had_changed);
 		thiz->state.buffer_changed = EINA_TRUE;
 		enesim_text_buffer_smart_clear(thiz->state.buffer);
 	}
@@ -372,18 +720,8 @@ next:
 	 */
 	else if (r_changed || s_changed || thiz->state.had_changed)
 	{
-		Enesim_Renderer_Text_Span_Propagate_Cb_Data cb_data;
-
-		cb_data.r = r;
-		cb_data.idx = 0;
-		cb_data.ox = 0;
-		cb_data.prev = NULL;
-		cb_data.has_kerning = enesim_text_font_has_kerning(thiz->state.current.font);
-
 		/* just propagate the properties */
-		enesim_renderer_compound_layer_foreach(thiz->compound,
-				_enesim_renderer_text_span_propagate_cb, &cb_data);
-		enesim_text_glyph_unref(cb_data.prev);
+		_enesim_renderer_text_span_glyphs_layout(thiz, 0, 0, EINA_TRUE);
 	}
 
 	return EINA_TRUE;
@@ -532,6 +870,7 @@ static void _enesim_renderer_text_span_cleanup(Enesim_Renderer_Text_Span *thiz,
 	thiz->state.buffer_changed = EINA_FALSE;
 	thiz->state.r_state_changed = EINA_FALSE;
 	thiz->state.s_state_changed = EINA_FALSE;
+	thiz->state.had_changed = EINA_FALSE;
 }
 /*----------------------------------------------------------------------------*
  *                             Shape interface                                *
@@ -723,6 +1062,8 @@ static void _enesim_renderer_text_span_instance_deinit(void *o)
 		enesim_text_buffer_unref(thiz->state.buffer);
 		thiz->state.buffer = NULL;
 	}
+	_enesim_renderer_text_span_glyphs_clear(thiz);
+	free(thiz->glyphs);
 	enesim_renderer_unref(thiz->compound);
 }
 
@@ -882,10 +1223,16 @@ EAPI Eina_Bool enesim_renderer_text_span_glyph_coord_at(Enesim_Renderer *r,
 			WRN("No such glyph for %08x", unicode);
 			continue;
 		}
-		if (!g->surface) goto advance;
-		/* check if the coord is inside the surface */
-		enesim_surface_size_get(g->surface, &w, &h);
-		w = g->x_advance < w ? g->x_advance : w;
+		if (!g->x_advance) goto advance;
+		/* check if the coord is inside the surface, in case it is
+		 * not loaded use the advance
+		 */
+		w = g->x_advance;
+		if (g->surface)
+		{
+			enesim_surface_size_get(g->surface, &w, &h);
+			w = g->x_advance < w ? g->x_advance : w;
+		}
 		if (x >= (rcoord - 1) && x < rcoord + w)
 		{
 			if (index) *index = idx;
@@ -938,10 +1285,16 @@ EAPI Eina_Bool enesim_renderer_text_span_glyph_index_at(Enesim_Renderer *r,
 			WRN("No such glyph for %08x", unicode);
 			continue;
 		}
-		if (!g->surface) goto advance;
-		/* check if the coord is inside the surface */
-		enesim_surface_size_get(g->surface, &w, &h);
-		w = g->x_advance < w ? g->x_advance : w;
+		if (!g->x_advance) goto advance;
+		/* check if the coord is inside the surface, in case it is
+		 * not loaded use the advance
+		 */
+		w = g->x_advance;
+		if (g->surface)
+		{
+			enesim_surface_size_get(g->surface, &w, &h);
+			w = g->x_advance < w ? g->x_advance : w;
+		}
 		if (index == idx)
 		{
 			double ox, oy;
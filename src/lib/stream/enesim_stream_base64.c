@@ -20,90 +20,167 @@
 #include "enesim_main.h"
 #include "enesim_stream.h"
 #include "enesim_stream_private.h"
-#include <ctype.h>
 /*============================================================================*
  *                                  Local                                     *
  *============================================================================*/
 /** @cond internal */
 #define ENESIM_LOG_DEFAULT enesim_log_global
 
+/* the size of the chunks to read in case the stream can not be mapped */
+#define ENESIM_STREAM_BASE64_CHUNK 4096
+
+/* the values on the decoding table that are not digits */
+#define ENESIM_STREAM_BASE64_PAD 0x40
+#define ENESIM_STREAM_BASE64_SKIP 0x80
+
 typedef struct _Enesim_Stream_Base64
 {
 	/* passed in */
 	Enesim_Stream *data;
 	/* last decoded data */
 	unsigned char last[3];
-	/* the next value to read */
+	/* the next value to read and the number of decoded values */
 	int last_offset;
-	size_t enclen;
-	size_t declen;
+	int last_len;
+	/* in case the stream can not be mapped the data is read in here */
+	Eina_Bool mapped;
 	char *buf;
 	char *curr;
 	char *end;
-	ssize_t offset;
 } Enesim_Stream_Base64;
 
-static Eina_Bool _base64_decode_digit(unsigned char c, unsigned char *v)
-{
-	switch (c)
-	{
-		case '+': *v = 62;
-		break;
+/* the value of every base64 digit, the padding and the characters to skip,
+ * like the line breaks
+ */
+static const unsigned char _base64_table[256] = {
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3e, 0x80, 0x80, 0x80, 0x3f,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x80, 0x80, 0x80, 0x40, 0x80, 0x80,
+	0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+	0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+};
 
-		case '/': *v = 63;
-		break;
+/* decode a group skipping the characters that are not digits. Returns the
+ * number of decoded bytes, less than three only at the end of the data
+ */
+static int _base64_group_decode(const unsigned char **in,
+		const unsigned char *end, unsigned char *o)
+{
+	const unsigned char *i = *in;
+	uint32_t v = 0;
+	int n = 0;
 
-		case '=': *v = 0;
-		break;
+	while (n < 4 && i < end)
+	{
+		unsigned char d = _base64_table[*i];
 
-		default:
-		if (isdigit(c)) *v = c - '0' + 52;
-		else if (islower(c)) *v = c - 'a' + 26;
-		else if (isupper(c)) *v = c - 'A';
-		else return EINA_FALSE;
-		break;
+		/* the padding marks the end of the data */
+		if (d == ENESIM_STREAM_BASE64_PAD)
+		{
+			i = end;
+			break;
+		}
+		i++;
+		if (d == ENESIM_STREAM_BASE64_SKIP)
+			continue;
+		v = (v << 6) | d;
+		n++;
 	}
-	return EINA_TRUE;
-}
+	*in = i;
+	v <<= 6 * (4 - n);
+	o[0] = (unsigned char)(v >> 16);
+	o[1] = (unsigned char)(v >> 8);
+	o[2] = (unsigned char)v;
 
-static void _base64_decode(unsigned char *in, unsigned char *out)
-{
-	out[0] = (unsigned char)(in[0] << 2 | in[1] >> 4);
-	out[1] = (unsigned char)(in[1] << 4 | in[2] >> 2);
-	out[2] = (unsigned char)(((in[2] << 6) & 0xc0) | in[3]);
+	return (n * 6) / 8;
 }
 
-/* 4 bytes in base64 give 3 decoded bytes
- * so the output mut be multiple of 3
+/* 4 bytes in base64 give 3 decoded bytes so the output must be multiple
+ * of 3. Returns the number of decoded bytes
  */
-static void _base64_decode_stream(unsigned char *in, size_t ilen, int *iread,
-		unsigned char *out, size_t olen, int *owrite)
+static size_t _base64_decode(Enesim_Stream_Base64 *thiz, unsigned char *out,
+		size_t olen)
 {
-	unsigned char dec[4];
-	unsigned char *i = in;
+	const unsigned char *i = (const unsigned char *)thiz->curr;
+	const unsigned char *end = (const unsigned char *)thiz->end;
 	unsigned char *o = out;
-	int count = 0;
+	unsigned char *oend = out + olen;
 
-	while (ilen > 0 && olen > 0)
+	while (o < oend)
 	{
-		if (!_base64_decode_digit(*i, &dec[count]))
-			goto next;
-		/* read the four input bytes */
-		count++;
-		if (count == 4)
+		int n;
+
+		/* four digits without line breaks nor padding, no branch per
+		 * character
+		 */
+		if (end - i >= 4)
 		{
-			_base64_decode(dec, o);
-			count = 0;
-			/* increment the buffer */
-			o += 3;
-			olen -= 3;
+			uint32_t a = _base64_table[i[0]];
+			uint32_t b = _base64_table[i[1]];
+			uint32_t c = _base64_table[i[2]];
+			uint32_t d = _base64_table[i[3]];
+
+			if (!((a | b | c | d) & (ENESIM_STREAM_BASE64_PAD |
+					ENESIM_STREAM_BASE64_SKIP)))
+			{
+				uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+
+				o[0] = (unsigned char)(v >> 16);
+				o[1] = (unsigned char)(v >> 8);
+				o[2] = (unsigned char)v;
+				o += 3;
+				i += 4;
+				continue;
+			}
 		}
-next:
-		ilen--;
-		i++;
+		if (i >= end)
+			break;
+		n = _base64_group_decode(&i, end, o);
+		o += n;
+		if (n < 3)
+			break;
 	}
-	*iread = i - in;
-	*owrite = o - out;
+	thiz->curr = (char *)i;
+
+	return o - out;
+}
+
+/* read the whole stream in case it can not be mapped */
+static char * _base64_stream_read(Enesim_Stream *d, size_t *size)
+{
+	char *buf = NULL;
+	size_t len = 0;
+	ssize_t ret;
+
+	do
+	{
+		char *tmp;
+
+		tmp = realloc(buf, len + ENESIM_STREAM_BASE64_CHUNK);
+		if (!tmp)
+		{
+			free(buf);
+			return NULL;
+		}
+		buf = tmp;
+		ret = enesim_stream_read(d, buf + len, ENESIM_STREAM_BASE64_CHUNK);
+		if (ret > 0)
+			len += ret;
+	} while (ret == ENESIM_STREAM_BASE64_CHUNK);
+
+	*size = len;
+	return buf;
 }
 /*----------------------------------------------------------------------------*
  *                      The Enesim Image Data interface                       *
@@ -114,74 +191,43 @@ static const char * _enesim_stream_base64_type_get(void)
 }
 
 /* when the user requests 3 bytes of base64 decoded data we need to read 4 bytes
- * so we always read more from the real source
+ * so the complete groups are decoded directly on the buffer and the rest on
+ * the last decoded data
  */
 static ssize_t _enesim_stream_base64_read(void *data, void *buffer, size_t len)
 {
 	Enesim_Stream_Base64 *thiz = data;
 	unsigned char *b = buffer;
-	int enclen;
-	int declen;
-	int decwrite;
-	int encread;
-	int rest;
-	size_t extra = 0;
 	size_t ret = 0;
+	size_t declen;
+	size_t decwrite;
 
-	/* early exit */
-	if (thiz->curr == thiz->end)
-	{
-		return 0;
-	}
 	/* first write the missing bytes from the previous read */
-	if (thiz->last_offset)
+	while (len && thiz->last_offset < thiz->last_len)
 	{
-		int offset;
-		size_t i;
-
-		offset = thiz->last_offset;
-		extra = 3 - offset;
-		if (len < extra)
-		{
-			extra = len;
-		}
-		for (i = offset; i < offset + extra; i++)
-		{
-			*b++ = thiz->last[i];
-			len--;
-		}
-		thiz->last_offset += extra;
-		if (!len) return len;
+		*b++ = thiz->last[thiz->last_offset++];
+		len--;
+		ret++;
 	}
+	if (!len || thiz->curr == thiz->end)
+		return ret;
 
-	ret = extra;
-	declen = len;
-	enclen = thiz->end - thiz->curr;
-
-	/* check if we need to not read complete, if so
-	 * only read all the data that fits on the buffer
-	 * padded to 3 bytes
-	 */
-	rest = (declen % 3);
-	declen -= rest;
-
-	_base64_decode_stream((unsigned char *)thiz->curr, enclen, &encread, b, declen, &decwrite);
+	declen = len - (len % 3);
+	decwrite = _base64_decode(thiz, b, declen);
 	b += decwrite;
-	thiz->curr += encread;
-	declen -= decwrite;
-	enclen -= encread;
+	len -= decwrite;
 	ret += decwrite;
 
-	if (rest)
+	if (len && len < 3)
 	{
-		int i;
-
-		_base64_decode_stream((unsigned char *)thiz->curr, enclen, &encread, thiz->last, 3, &decwrite);
-		for (i = 0; i < rest; i++)
-			*b++ = thiz->last[i];
-		thiz->last_offset = rest;
-		thiz->curr += encread;
-		ret += rest;
+		thiz->last_len = _base64_decode(thiz, thiz->last, 3);
+		thiz->last_offset = 0;
+		while (len && thiz->last_offset < thiz->last_len)
+		{
+			*b++ = thiz->last[thiz->last_offset++];
+			len--;
+			ret++;
+		}
 	}
 
 	return ret;
@@ -192,6 +238,7 @@ static void _enesim_stream_base64_reset(void *data)
 	Enesim_Stream_Base64 *thiz = data;
 	thiz->curr = thiz->buf;
 	thiz->last_offset = 0;
+	thiz->last_len = 0;
 }
 
 static const char * _enesim_stream_base64_uri_get(void *data)
@@ -204,7 +251,10 @@ static void _enesim_stream_base64_free(void *data)
 {
 	Enesim_Stream_Base64 *thiz = data;
 
-	enesim_stream_munmap(thiz->data, thiz->buf);
+	if (thiz->mapped)
+		enesim_stream_munmap(thiz->data, thiz->buf);
+	else
+		free(thiz->buf);
 	enesim_stream_unref(thiz->data);
 	free(thiz);
 }
@@ -228,23 +278,30 @@ static Enesim_Stream_Descriptor _enesim_stream_base64_descriptor = {
  * @brief Create a new base64 based stream
  * @param[in] d The stream that holds the base64 data @ender_transfer{full}
  * @return A new base64 enesim stream
+ *
+ * The base64 data is decoded directly from the memory of @p d in case it
+ * can be mapped, otherwise the whole stream is read first.
  */
 EAPI Enesim_Stream * enesim_stream_base64_new(Enesim_Stream *d)
 {
 	Enesim_Stream_Base64 *thiz;
+	Eina_Bool mapped = EINA_TRUE;
 	char *buf;
 	size_t size;
 
 	buf = enesim_stream_mmap(d, &size);
-	if (!buf) return NULL;
+	if (!buf)
+	{
+		buf = _base64_stream_read(d, &size);
+		if (!buf) return NULL;
+		mapped = EINA_FALSE;
+	}
 
 	thiz = calloc(1, sizeof(Enesim_Stream_Base64));
 	thiz->data = d;
+	thiz->mapped = mapped;
 	thiz->buf = thiz->curr = buf;
 	thiz->end = thiz->buf + size;
-	thiz->enclen = size;
-	thiz->declen = (size / 4) * 3;
-	thiz->offset = 0;
 
 	return enesim_stream_new(&_enesim_stream_base64_descriptor, thiz);
 }
@@ -116,6 +116,12 @@ static void * _enesim_stream_file_mmap(void *data, size_t *size)
 			thiz->fd, 0);
 	if (ret == MAP_FAILED)
 		return NULL;
+#ifdef MADV_SEQUENTIAL
+	/* the mapped files are usually decoded from start to end, let the
+	 * system read ahead aggressively and drop the pages already read
+	 */
+	madvise(ret, *size, MADV_SEQUENTIAL);
+#endif
 	return ret;
 }
 
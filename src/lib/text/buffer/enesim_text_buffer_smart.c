@@ -33,7 +33,80 @@ typedef struct _Enesim_Text_Buffer_Smart
 {
 	Enesim_Text_Buffer *real;
 	Eina_Bool dirty;
+	/* the characters that have changed since the last clear. The ones
+	 * before start are the same, the ones from end are the same but
+	 * displaced by delta
+	 */
+	Eina_Bool ranged;
+	int start;
+	int end;
+	int delta;
 } Enesim_Text_Buffer_Smart;
+
+static void _smart_dirty_all(Enesim_Text_Buffer_Smart *thiz)
+{
+	thiz->dirty = EINA_TRUE;
+	thiz->ranged = EINA_FALSE;
+}
+
+static void _smart_dirty_insert(Enesim_Text_Buffer_Smart *thiz, int offset,
+		int length)
+{
+	if (thiz->dirty && !thiz->ranged)
+		return;
+	if (!thiz->dirty)
+	{
+		thiz->start = offset;
+		thiz->end = offset + length;
+		thiz->delta = length;
+	}
+	else
+	{
+		if (thiz->end >= offset)
+			thiz->end += length;
+		if (thiz->end < offset + length)
+			thiz->end = offset + length;
+		if (thiz->start > offset)
+			thiz->start = offset;
+		thiz->delta += length;
+	}
+	thiz->dirty = EINA_TRUE;
+	thiz->ranged = EINA_TRUE;
+}
+
+static inline int _smart_dirty_delete_map(int pos, int offset, int length)
+{
+	if (pos < offset)
+		return pos;
+	if (pos < offset + length)
+		return offset;
+	return pos - length;
+}
+
+static void _smart_dirty_delete(Enesim_Text_Buffer_Smart *thiz, int offset,
+		int length)
+{
+	if (thiz->dirty && !thiz->ranged)
+		return;
+	if (!thiz->dirty)
+	{
+		thiz->start = offset;
+		thiz->end = offset;
+		thiz->delta = -length;
+	}
+	else
+	{
+		thiz->start = _smart_dirty_delete_map(thiz->start, offset, length);
+		thiz->end = _smart_dirty_delete_map(thiz->end, offset, length);
+		if (thiz->start > offset)
+			thiz->start = offset;
+		if (thiz->end < offset)
+			thiz->end = offset;
+		thiz->delta -= length;
+	}
+	thiz->dirty = EINA_TRUE;
+	thiz->ranged = EINA_TRUE;
+}
 /*----------------------------------------------------------------------------*
  *                           Text buffer interface                            *
  *----------------------------------------------------------------------------*/
@@ -47,7 +120,7 @@ static void _smart_string_set(void *data, const char *string, int length)
 	Enesim_Text_Buffer_Smart *thiz = data;
 	if (thiz->real)
 	{
-		thiz->dirty = EINA_TRUE;
+		_smart_dirty_all(thiz);
 		enesim_text_buffer_string_set(thiz->real, string, length);
 	}
 }
@@ -57,8 +130,18 @@ static int _smart_string_insert(void *data, const char *string, int length, ssiz
 	Enesim_Text_Buffer_Smart *thiz = data;
 	if (thiz->real)
 	{
-		thiz->dirty = EINA_TRUE;
-		return enesim_text_buffer_string_insert(thiz->real, string, length, offset);
+		int old_length;
+		int ret;
+
+		old_length = enesim_text_buffer_length_get(thiz->real);
+		ret = enesim_text_buffer_string_insert(thiz->real, string, length, offset);
+		if (ret <= 0)
+			return ret;
+		/* same offset sanitizing as the buffers */
+		if (offset < 0 || offset > old_length)
+			offset = old_length;
+		_smart_dirty_insert(thiz, offset, ret);
+		return ret;
 	}
 	return 0;
 }
@@ -68,8 +151,18 @@ static int _smart_string_delete(void *data, int length, ssize_t offset)
 	Enesim_Text_Buffer_Smart *thiz = data;
 	if (thiz->real)
 	{
-		thiz->dirty = EINA_TRUE;
-		return enesim_text_buffer_string_delete(thiz->real, length, offset);
+		int old_length;
+		int ret;
+
+		old_length = enesim_text_buffer_length_get(thiz->real);
+		ret = enesim_text_buffer_string_delete(thiz->real, length, offset);
+		if (ret <= 0)
+			return ret;
+		/* a negative offset deletes from the end */
+		if (offset < 0)
+			offset = old_length - ret;
+		_smart_dirty_delete(thiz, offset, ret);
+		return ret;
 	}
 	return 0;
 }
@@ -147,7 +240,7 @@ EAPI void enesim_text_buffer_smart_real_set(Enesim_Text_Buffer *b,
 		thiz->real = NULL;
 	}
 	thiz->real = real;
-	thiz->dirty = EINA_TRUE;
+	_smart_dirty_all(thiz);
 }
 
 EAPI void enesim_text_buffer_smart_dirty(Enesim_Text_Buffer *b)
@@ -155,7 +248,7 @@ EAPI void enesim_text_buffer_smart_dirty(Enesim_Text_Buffer *b)
 	Enesim_Text_Buffer_Smart *thiz;
 
 	thiz = enesim_text_buffer_data_get(b);
-	thiz->dirty = EINA_TRUE;
+	_smart_dirty_all(thiz);
 }
 
 EAPI void enesim_text_buffer_smart_clear(Enesim_Text_Buffer *b)
@@ -164,6 +257,7 @@ EAPI void enesim_text_buffer_smart_clear(Enesim_Text_Buffer *b)
 
 	thiz = enesim_text_buffer_data_get(b);
 	thiz->dirty = EINA_FALSE;
+	thiz->ranged = EINA_FALSE;
 }
 
 EAPI Eina_Bool enesim_text_buffer_smart_is_dirty(Enesim_Text_Buffer *b)
@@ -173,3 +267,31 @@ EAPI Eina_Bool enesim_text_buffer_smart_is_dirty(Enesim_Text_Buffer *b)
 	thiz = enesim_text_buffer_data_get(b);
 	return thiz->dirty;
 }
+
+/**
+ * @brief Gets the range of characters that have changed on a smart buffer
+ * @param[in] b The smart buffer
+ * @param[out] start The first character that has changed
+ * @param[out] end The character after the last one that has changed
+ * @param[out] delta The difference of length of the buffer
+ * @return EINA_TRUE if only the range has changed, EINA_FALSE if the buffer
+ * is not dirty or the whole buffer must be considered as changed
+ *
+ * Every character before @p start is the same as before, every character
+ * from @p end is the same as the character at its position minus
+ * @p delta before the changes. The range is only tracked for the insertions
+ * and deletions, any other change marks the whole buffer as dirty.
+ */
+EAPI Eina_Bool enesim_text_buffer_smart_dirty_range_get(Enesim_Text_Buffer *b,
+		int *start, int *end, int *delta)
+{
+	Enesim_Text_Buffer_Smart *thiz;
+
+	thiz = enesim_text_buffer_data_get(b);
+	if (!thiz->dirty || !thiz->ranged)
+		return EINA_FALSE;
+	if (start) *start = thiz->start;
+	if (end) *end = thiz->end;
+	if (delta) *delta = thiz->delta;
+	return EINA_TRUE;
+}
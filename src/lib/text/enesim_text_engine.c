@@ -27,12 +27,77 @@
 
 #include "enesim_text.h"
 #include "enesim_text_private.h"
+
+#include <time.h>
 /*============================================================================*
  *                                  Local                                     *
  *============================================================================*/
 /** @cond internal */
 #define ENESIM_LOG_DEFAULT enesim_log_text
 
+
+typedef struct _Enesim_Text_Engine_Glyph
+{
+	EINA_INLIST;
+	/* the font hash this glyph belongs to */
+	Eina_Hash *owner;
+	int key;
+	Enesim_Surface *surface;
+	Enesim_Path *path;
+	int origin;
+	int x_advance;
+	size_t memory;
+	time_t last_used;
+} Enesim_Text_Engine_Glyph;
+
+static void _enesim_text_engine_glyph_free(Enesim_Text_Engine *thiz,
+		Enesim_Text_Engine_Glyph *eg)
+{
+	thiz->glyphs.lru = eina_inlist_remove(thiz->glyphs.lru,
+			EINA_INLIST_GET(eg));
+	thiz->glyphs.memory -= eg->memory;
+	eina_hash_del(eg->owner, &eg->key, eg);
+	/* the font does not have any glyph left */
+	if (!eina_hash_population(eg->owner))
+		eina_hash_del_by_data(thiz->glyphs.fonts, eg->owner);
+	if (eg->surface)
+		enesim_surface_unref(eg->surface);
+	if (eg->path)
+		enesim_path_unref(eg->path);
+	free(eg);
+}
+
+/* remove the least recently used glyphs while we are over the size or
+ * they have not been used for the timeout
+ */
+static void _enesim_text_engine_glyphs_evict(Enesim_Text_Engine *thiz,
+		time_t now)
+{
+	while (thiz->glyphs.lru)
+	{
+		Enesim_Text_Engine_Glyph *eg;
+
+		eg = EINA_INLIST_CONTAINER_GET(thiz->glyphs.lru->last,
+				Enesim_Text_Engine_Glyph);
+		if (thiz->glyphs.memory <= thiz->glyphs.size &&
+				(unsigned int)(now - eg->last_used) <= thiz->glyphs.timeout)
+			break;
+		_enesim_text_engine_glyph_free(thiz, eg);
+	}
+}
+
+static void _enesim_text_engine_glyphs_flush(Enesim_Text_Engine *thiz)
+{
+	while (thiz->glyphs.lru)
+	{
+		Enesim_Text_Engine_Glyph *eg;
+
+		eg = EINA_INLIST_CONTAINER_GET(thiz->glyphs.lru,
+				Enesim_Text_Engine_Glyph);
+		_enesim_text_engine_glyph_free(thiz, eg);
+	}
+}
+
 ENESIM_OBJECT_ABSTRACT_BOILERPLATE(ENESIM_OBJECT_DESCRIPTOR, Enesim_Text_Engine,
 		Enesim_Text_Engine_Class, enesim_text_engine);
 /*----------------------------------------------------------------------------*
@@ -46,6 +111,11 @@ static void _enesim_text_engine_instance_init(void *o)
 {
 	Enesim_Text_Engine *thiz = o;
 	thiz->fonts = eina_hash_string_superfast_new(NULL);
+	thiz->glyphs.fonts = eina_hash_string_superfast_new(
+			EINA_FREE_CB(eina_hash_free));
+	thiz->glyphs.size = ENESIM_TEXT_ENGINE_GLYPH_CACHE_SIZE;
+	thiz->glyphs.timeout = ENESIM_TEXT_ENGINE_GLYPH_CACHE_TIMEOUT;
+	eina_lock_new(&thiz->glyphs.lock);
 	thiz->ref = 1;
 }
 
@@ -53,6 +123,9 @@ static void _enesim_text_engine_instance_deinit(void *o)
 {
 	Enesim_Text_Engine *thiz = o;
 	eina_hash_free(thiz->fonts);
+	_enesim_text_engine_glyphs_flush(thiz);
+	eina_hash_free(thiz->glyphs.fonts);
+	eina_lock_free(&thiz->glyphs.lock);
 }
 /*============================================================================*
  *                                 Global                                     *
@@ -108,6 +181,103 @@ void enesim_text_engine_font_uncache(Enesim_Text_Engine *thiz,
 {
 	eina_hash_del(thiz->fonts, &f->key, f);
 }
+
+/* Set the requested formats of a glyph from the rasterized glyphs of the
+ * engine. Returns the formats that are not found
+ */
+int enesim_text_engine_glyph_cache_get(Enesim_Text_Engine *thiz,
+		Enesim_Text_Glyph *g, int subpixel, int formats)
+{
+	Enesim_Text_Engine_Glyph *eg = NULL;
+	Eina_Hash *glyphs;
+	time_t now;
+	int key;
+
+	if (!thiz || !g->font->key || !thiz->glyphs.size)
+		return formats;
+
+	key = ENESIM_TEXT_GLYPH_KEY(g->code, subpixel);
+	now = time(NULL);
+	eina_lock_take(&thiz->glyphs.lock);
+	/* do not hand out glyphs that have already timed out */
+	_enesim_text_engine_glyphs_evict(thiz, now);
+	glyphs = eina_hash_find(thiz->glyphs.fonts, g->font->key);
+	if (glyphs)
+		eg = eina_hash_find(glyphs, &key);
+	if (!eg)
+		goto done;
+
+	if ((formats & ENESIM_TEXT_GLYPH_FORMAT_SURFACE) && eg->surface)
+	{
+		g->surface = enesim_surface_ref(eg->surface);
+		formats &= ~ENESIM_TEXT_GLYPH_FORMAT_SURFACE;
+	}
+	if ((formats & ENESIM_TEXT_GLYPH_FORMAT_PATH) && eg->path)
+	{
+		g->path = enesim_path_ref(eg->path);
+		formats &= ~ENESIM_TEXT_GLYPH_FORMAT_PATH;
+	}
+	g->origin = eg->origin;
+	g->x_advance = eg->x_advance;
+	eg->last_used = now;
+	thiz->glyphs.lru = eina_inlist_promote(thiz->glyphs.lru,
+			EINA_INLIST_GET(eg));
+done:
+	eina_lock_release(&thiz->glyphs.lock);
+	return formats;
+}
+
+/* Share the loaded formats of a glyph with the rest of the fonts */
+void enesim_text_engine_glyph_cache_add(Enesim_Text_Engine *thiz,
+		Enesim_Text_Glyph *g, int subpixel)
+{
+	Enesim_Text_Engine_Glyph *eg;
+	Eina_Hash *glyphs;
+	time_t now;
+	int key;
+
+	if (!thiz || !g->font->key || !thiz->glyphs.size)
+		return;
+	if (!g->surface && !g->path)
+		return;
+
+	key = ENESIM_TEXT_GLYPH_KEY(g->code, subpixel);
+	now = time(NULL);
+	eina_lock_take(&thiz->glyphs.lock);
+	glyphs = eina_hash_find(thiz->glyphs.fonts, g->font->key);
+	if (!glyphs)
+	{
+		glyphs = eina_hash_int32_new(NULL);
+		eina_hash_add(thiz->glyphs.fonts, g->font->key, glyphs);
+	}
+	eg = eina_hash_find(glyphs, &key);
+	if (!eg)
+	{
+		eg = calloc(1, sizeof(Enesim_Text_Engine_Glyph));
+		eg->owner = glyphs;
+		eg->key = key;
+		eina_hash_add(glyphs, &eg->key, eg);
+	}
+	else
+	{
+		thiz->glyphs.lru = eina_inlist_remove(thiz->glyphs.lru,
+				EINA_INLIST_GET(eg));
+		thiz->glyphs.memory -= eg->memory;
+	}
+	if (!eg->surface && g->surface)
+		eg->surface = enesim_surface_ref(g->surface);
+	if (!eg->path && g->path)
+		eg->path = enesim_path_ref(g->path);
+	eg->origin = g->origin;
+	eg->x_advance = g->x_advance;
+	eg->last_used = now;
+	eg->memory = enesim_text_glyph_formats_memory_get(eg->surface, eg->path);
+	thiz->glyphs.memory += eg->memory;
+	thiz->glyphs.lru = eina_inlist_prepend(thiz->glyphs.lru,
+			EINA_INLIST_GET(eg));
+	_enesim_text_engine_glyphs_evict(thiz, now);
+	eina_lock_release(&thiz->glyphs.lock);
+}
 /** @endcond */
 /*============================================================================*
  *                                   API                                      *
@@ -161,3 +331,74 @@ EAPI Eina_Bool enesim_text_engine_type_get(Enesim_Text_Engine *thiz,
 	}
 	return EINA_TRUE;
 }
+
+/**
+ * @brief Sets the maximum memory of the rasterized glyphs cache
+ * @param[in] thiz The text engine to set the size on
+ * @param[in] size The number of bytes, 0 to disable the cache
+ *
+ * Every engine keeps the rasterized glyphs of its fonts, keyed by the font
+ * file, index and size, so loading the same font again does not need to
+ * rasterize the glyphs again.
+ */
+EAPI void enesim_text_engine_glyph_cache_size_set(Enesim_Text_Engine *thiz,
+		size_t size)
+{
+	if (!thiz) return;
+	eina_lock_take(&thiz->glyphs.lock);
+	thiz->glyphs.size = size;
+	_enesim_text_engine_glyphs_evict(thiz, time(NULL));
+	eina_lock_release(&thiz->glyphs.lock);
+}
+
+/**
+ * @brief Gets the maximum memory of the rasterized glyphs cache
+ * @param[in] thiz The text engine to get the size from
+ * @return The number of bytes
+ */
+EAPI size_t enesim_text_engine_glyph_cache_size_get(Enesim_Text_Engine *thiz)
+{
+	if (!thiz) return 0;
+	return thiz->glyphs.size;
+}
+
+/**
+ * @brief Sets the time a rasterized glyph is kept without being used
+ * @param[in] thiz The text engine to set the timeout on
+ * @param[in] timeout The number of seconds
+ */
+EAPI void enesim_text_engine_glyph_cache_timeout_set(Enesim_Text_Engine *thiz,
+		unsigned int timeout)
+{
+	if (!thiz) return;
+	eina_lock_take(&thiz->glyphs.lock);
+	thiz->glyphs.timeout = timeout;
+	_enesim_text_engine_glyphs_evict(thiz, time(NULL));
+	eina_lock_release(&thiz->glyphs.lock);
+}
+
+/**
+ * @brief Gets the time a rasterized glyph is kept without being used
+ * @param[in] thiz The text engine to get the timeout from
+ * @return The number of seconds
+ */
+EAPI unsigned int enesim_text_engine_glyph_cache_timeout_get(
+		Enesim_Text_Engine *thiz)
+{
+	if (!thiz) return 0;
+	return thiz->glyphs.timeout;
+}
+
+/**
+ * @brief Removes every rasterized glyph from the cache
+ * @param[in] thiz The text engine to flush the cache of
+ *
+ * The glyphs in use by the fonts are not affected.
+ */
+EAPI void enesim_text_engine_glyph_cache_flush(Enesim_Text_Engine *thiz)
+{
+	if (!thiz) return;
+	eina_lock_take(&thiz->glyphs.lock);
+	_enesim_text_engine_glyphs_flush(thiz);
+	eina_lock_release(&thiz->glyphs.lock);
+}
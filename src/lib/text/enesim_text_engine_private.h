@@ -33,10 +33,27 @@
 #define ENESIM_TEXT_ENGINE(o) ENESIM_OBJECT_INSTANCE_CHECK(o, 			\
 		Enesim_Text_Engine, ENESIM_TEXT_ENGINE_DESCRIPTOR)
 
+/* the default limits of the glyph cache */
+#define ENESIM_TEXT_ENGINE_GLYPH_CACHE_SIZE (4 * 1024 * 1024)
+#define ENESIM_TEXT_ENGINE_GLYPH_CACHE_TIMEOUT 30
+
 struct _Enesim_Text_Engine
 {
 	Enesim_Object_Instance parent;
 	Eina_Hash *fonts;
+	/* the rasterized glyphs, shared by every font of the engine and kept
+	 * after the fonts are gone
+	 */
+	struct {
+		/* the font key to a hash of glyphs */
+		Eina_Hash *fonts;
+		/* the most recently used first */
+		Eina_Inlist *lru;
+		size_t memory;
+		size_t size;
+		unsigned int timeout;
+		Eina_Lock lock;
+	} glyphs;
 	int ref;
 };
 
@@ -56,5 +73,9 @@ void enesim_text_engine_font_cache(Enesim_Text_Engine *thiz,
 		Enesim_Text_Font *f);
 void enesim_text_engine_font_uncache(Enesim_Text_Engine *thiz,
 		Enesim_Text_Font *f);
+int enesim_text_engine_glyph_cache_get(Enesim_Text_Engine *thiz,
+		Enesim_Text_Glyph *g, int subpixel, int formats);
+void enesim_text_engine_glyph_cache_add(Enesim_Text_Engine *thiz,
+		Enesim_Text_Glyph *g, int subpixel);
 
 #endif
@@ -45,6 +45,7 @@ static Eina_Bool _dump(const Eina_Hash *hash EINA_UNUSED, const void *key, void
 	char fout[PATH_MAX];
 	char *path = fdata;
 
+	if (!g->surface) return EINA_TRUE;
 	b = enesim_surface_buffer_get(g->surface);
 	snprintf(fout, PATH_MAX, "%s/%c.png", path, c);
 	enesim_image_file_save(fout, b, NULL, NULL);
@@ -53,6 +54,80 @@ static Eina_Bool _dump(const Eina_Hash *hash EINA_UNUSED, const void *key, void
 	return EINA_TRUE;
 }
 
+/* unload the formats of the least recently used glyphs until we are
+ * under the budget. Only the glyphs referenced by the cache alone can be
+ * unloaded, the rest are still in use
+ */
+static void _enesim_text_font_glyphs_evict(Enesim_Text_Font *thiz)
+{
+	Eina_Inlist *l;
+
+	if (!thiz->budget || !thiz->lru)
+		return;
+
+	l = thiz->lru->last;
+	while (l && thiz->memory > thiz->budget)
+	{
+		Enesim_Text_Glyph *g;
+		Eina_Inlist *prev = l->prev;
+
+		g = EINA_INLIST_CONTAINER_GET(l, Enesim_Text_Glyph);
+		if (g->cache && g->ref == 1)
+		{
+			enesim_text_glyph_unload(g,
+					ENESIM_TEXT_GLYPH_FORMAT_SURFACE |
+					ENESIM_TEXT_GLYPH_FORMAT_PATH);
+		}
+		l = prev;
+	}
+}
+
+/* get the slot of a code point on the direct table, NULL for the code
+ * points outside the BMP that are only on the hash
+ */
+static inline Enesim_Text_Glyph ** _enesim_text_font_glyph_slot_get(
+		Enesim_Text_Font *thiz, Eina_Unicode c, Eina_Bool alloc)
+{
+	Enesim_Text_Glyph **page;
+	unsigned int idx;
+
+	if (c < ENESIM_TEXT_FONT_GLYPHS_PAGE_SIZE)
+		return &thiz->latin1[c];
+	idx = c / ENESIM_TEXT_FONT_GLYPHS_PAGE_SIZE;
+	if (idx >= ENESIM_TEXT_FONT_GLYPHS_PAGES)
+		return NULL;
+	page = thiz->pages[idx];
+	if (!page)
+	{
+		if (!alloc)
+			return NULL;
+		page = calloc(ENESIM_TEXT_FONT_GLYPHS_PAGE_SIZE,
+				sizeof(Enesim_Text_Glyph *));
+		thiz->pages[idx] = page;
+	}
+	return &page[c % ENESIM_TEXT_FONT_GLYPHS_PAGE_SIZE];
+}
+
+static int _enesim_text_font_glyph_cmp(const void *a, const void *b)
+{
+	const Enesim_Text_Glyph *ga = *(const Enesim_Text_Glyph **)a;
+	const Enesim_Text_Glyph *gb = *(const Enesim_Text_Glyph **)b;
+
+	if (ga < gb) return -1;
+	if (ga > gb) return 1;
+	return 0;
+}
+
+static inline int _enesim_text_font_glyph_missing_get(Enesim_Text_Glyph *g,
+		int formats)
+{
+	if (g->surface)
+		formats &= ~ENESIM_TEXT_GLYPH_FORMAT_SURFACE;
+	if (g->path)
+		formats &= ~ENESIM_TEXT_GLYPH_FORMAT_PATH;
+	return formats;
+}
+
 ENESIM_OBJECT_ABSTRACT_BOILERPLATE(ENESIM_OBJECT_DESCRIPTOR, Enesim_Text_Font,
 		Enesim_Text_Font_Class, enesim_text_font);
 /*----------------------------------------------------------------------------*
@@ -67,15 +142,20 @@ static void _enesim_text_font_instance_init(void *o)
 	Enesim_Text_Font *thiz = o;
 
 	thiz->glyphs = eina_hash_int32_new(NULL);
+	thiz->variants = eina_hash_int32_new(NULL);
 	thiz->ref = 1;
 }
 
 static void _enesim_text_font_instance_deinit(void *o)
 {
 	Enesim_Text_Font *thiz = o;
+	int i;
 
 	enesim_text_engine_unref(thiz->engine);
 	eina_hash_free(thiz->glyphs);
+	eina_hash_free(thiz->variants);
+	for (i = 0; i < ENESIM_TEXT_FONT_GLYPHS_PAGES; i++)
+		free(thiz->pages[i]);
 	free(thiz->key);
 }
 /*============================================================================*
@@ -88,7 +168,18 @@ Enesim_Text_Glyph * enesim_text_font_glyph_get(Enesim_Text_Font *thiz, Eina_Unic
 
 	if (!thiz)
 		return NULL;
-	g = eina_hash_find(thiz->glyphs, &c);
+	if (c < ENESIM_TEXT_FONT_GLYPHS_PAGE_SIZE * ENESIM_TEXT_FONT_GLYPHS_PAGES)
+	{
+		Enesim_Text_Glyph **slot;
+
+		/* the table has every cached glyph of the BMP */
+		slot = _enesim_text_font_glyph_slot_get(thiz, c, EINA_FALSE);
+		g = slot ? *slot : NULL;
+	}
+	else
+	{
+		g = eina_hash_find(thiz->glyphs, &c);
+	}
 	if (g)
 		return enesim_text_glyph_ref(g);
 	klass = ENESIM_TEXT_FONT_CLASS_GET(thiz);
@@ -102,6 +193,37 @@ Enesim_Text_Glyph * enesim_text_font_glyph_get(Enesim_Text_Font *thiz, Eina_Unic
 	return g;
 }
 
+/* Get the glyph of a code point rasterized at a subpixel position. The
+ * metrics are the same as the ones of the glyph at the pixel position
+ */
+Enesim_Text_Glyph * enesim_text_font_glyph_variant_get(Enesim_Text_Font *thiz,
+		Eina_Unicode c, int subpixel)
+{
+	Enesim_Text_Glyph *g;
+	Enesim_Text_Font_Class *klass;
+	int key;
+
+	if (!thiz)
+		return NULL;
+	if (!subpixel)
+		return enesim_text_font_glyph_get(thiz, c);
+
+	key = ENESIM_TEXT_GLYPH_KEY(c, subpixel);
+	g = eina_hash_find(thiz->variants, &key);
+	if (g)
+		return enesim_text_glyph_ref(g);
+	klass = ENESIM_TEXT_FONT_CLASS_GET(thiz);
+	if (klass->glyph_get)
+	{
+		g = klass->glyph_get(thiz, c);
+		if (!g) return NULL;
+		g->font = enesim_text_font_ref(thiz);
+		g->code = c;
+		g->subpixel = subpixel;
+	}
+	return g;
+}
+
 Eina_Bool enesim_text_font_has_kerning(Enesim_Text_Font *thiz)
 {
 	Enesim_Text_Font_Class *klass;
@@ -131,12 +253,130 @@ void enesim_text_font_uncache(Enesim_Text_Font *thiz)
 
 void enesim_text_font_glyph_cache(Enesim_Text_Font *thiz, Enesim_Text_Glyph *g)
 {
+	Enesim_Text_Glyph **slot;
+
+	if (g->subpixel)
+	{
+		int key = ENESIM_TEXT_GLYPH_KEY(g->code, g->subpixel);
+
+		eina_hash_add(thiz->variants, &key, g);
+		return;
+	}
 	eina_hash_add(thiz->glyphs, &g->code, g);
+	slot = _enesim_text_font_glyph_slot_get(thiz, g->code, EINA_TRUE);
+	if (slot) *slot = g;
 }
 
 void enesim_text_font_glyph_uncache(Enesim_Text_Font *thiz, Enesim_Text_Glyph *g)
 {
+	Enesim_Text_Glyph **slot;
+
+	if (g->subpixel)
+	{
+		int key = ENESIM_TEXT_GLYPH_KEY(g->code, g->subpixel);
+
+		eina_hash_del(thiz->variants, &key, g);
+		return;
+	}
 	eina_hash_del(thiz->glyphs, &g->code, g);
+	slot = _enesim_text_font_glyph_slot_get(thiz, g->code, EINA_FALSE);
+	if (slot && *slot == g) *slot = NULL;
+}
+
+/* Account the memory of the formats loaded on a glyph. A used glyph
+ * becomes the most recently used one, an unloaded one goes to the end
+ */
+void enesim_text_font_glyph_memory_update(Enesim_Text_Font *thiz,
+		Enesim_Text_Glyph *g, Eina_Bool used)
+{
+	size_t memory;
+
+	memory = enesim_text_glyph_memory_get(g);
+	/* only the glyphs with memory are on the list */
+	if (g->memory)
+	{
+		thiz->lru = eina_inlist_remove(thiz->lru, EINA_INLIST_GET(g));
+		thiz->memory -= g->memory;
+	}
+	g->memory = memory;
+	if (memory)
+	{
+		thiz->memory += memory;
+		if (used)
+			thiz->lru = eina_inlist_prepend(thiz->lru, EINA_INLIST_GET(g));
+		else
+			thiz->lru = eina_inlist_append(thiz->lru, EINA_INLIST_GET(g));
+	}
+	if (used)
+		_enesim_text_font_glyphs_evict(thiz);
+}
+
+/* Load the formats of several glyphs at once. In case the font supports it
+ * and enough glyphs are missing, those are loaded in parallel. Otherwise
+ * nothing is done and the glyphs are loaded one by one later
+ */
+void enesim_text_font_glyphs_load(Enesim_Text_Font *thiz,
+		Enesim_Text_Glyph **glyphs, int count, int formats)
+{
+	Enesim_Text_Font_Class *klass;
+	Enesim_Text_Glyph **pending;
+	Enesim_Text_Glyph *last = NULL;
+	int npending = 0;
+	int i;
+
+	klass = ENESIM_TEXT_FONT_CLASS_GET(thiz);
+	if (!klass->glyphs_load || count < ENESIM_TEXT_FONT_GLYPHS_PARALLEL_THRESHOLD)
+		return;
+
+	pending = malloc(count * sizeof(Enesim_Text_Glyph *));
+	if (!pending)
+		return;
+	for (i = 0; i < count; i++)
+	{
+		if (!glyphs[i])
+			continue;
+		if (!_enesim_text_font_glyph_missing_get(glyphs[i], formats))
+			continue;
+		pending[npending++] = glyphs[i];
+	}
+	/* the same glyph can be several times on the text */
+	qsort(pending, npending, sizeof(Enesim_Text_Glyph *),
+			_enesim_text_font_glyph_cmp);
+	count = npending;
+	npending = 0;
+	for (i = 0; i < count; i++)
+	{
+		Enesim_Text_Glyph *g = pending[i];
+		int missing;
+
+		if (g == last)
+			continue;
+		last = g;
+		/* first the glyphs already rasterized */
+		missing = _enesim_text_font_glyph_missing_get(g, formats);
+		missing = enesim_text_engine_glyph_cache_get(thiz->engine, g,
+				g->subpixel, missing);
+		if (!missing)
+		{
+			enesim_text_font_glyph_memory_update(thiz, g, EINA_TRUE);
+			continue;
+		}
+		pending[npending++] = g;
+	}
+
+	if (npending >= ENESIM_TEXT_FONT_GLYPHS_PARALLEL_THRESHOLD)
+	{
+		klass->glyphs_load(thiz, pending, npending, formats);
+		/* the accounting is done serially */
+		for (i = 0; i < npending; i++)
+		{
+			enesim_text_engine_glyph_cache_add(thiz->engine,
+					pending[i], pending[i]->subpixel);
+			enesim_text_font_glyph_memory_update(thiz, pending[i],
+					EINA_TRUE);
+		}
+	}
+	free(pending);
 }
 
 void enesim_text_font_dump(Enesim_Text_Font *thiz, const char *path)
@@ -226,3 +466,44 @@ EAPI int enesim_text_font_max_descent_get(Enesim_Text_Font *thiz)
 	else
 		return 0;
 }
+
+/**
+ * @brief Sets the maximum memory the glyphs of a font can use
+ * @param[in] thiz The font to set the budget on
+ * @param[in] budget The number of bytes, 0 for no limit
+ *
+ * Whenever the glyphs of the font use more memory than the budget, the
+ * surfaces and paths of the least recently used glyphs are released. Only
+ * the glyphs that are not in use are released, so the memory used can be
+ * higher than the budget. The formats are loaded again when needed.
+ */
+EAPI void enesim_text_font_glyphs_budget_set(Enesim_Text_Font *thiz,
+		size_t budget)
+{
+	if (!thiz) return;
+	thiz->budget = budget;
+	_enesim_text_font_glyphs_evict(thiz);
+}
+
+/**
+ * @brief Gets the maximum memory the glyphs of a font can use
+ * @param[in] thiz The font to get the budget from
+ * @return The number of bytes, 0 for no limit
+ */
+EAPI size_t enesim_text_font_glyphs_budget_get(Enesim_Text_Font *thiz)
+{
+	if (!thiz) return 0;
+	return thiz->budget;
+}
+
+/**
+ * @brief Gets the memory used by the glyphs of a font
+ * @param[in] thiz The font to get the memory from
+ * @return The approximated number of bytes used by the glyph surfaces and
+ * paths
+ */
+EAPI size_t enesim_text_font_glyphs_memory_get(Enesim_Text_Font *thiz)
+{
+	if (!thiz) return 0;
+	return thiz->memory;
+}
@@ -36,11 +36,31 @@
 /* forward declarations */
 typedef struct _Enesim_Text_Glyph Enesim_Text_Glyph;
 
+/* the number of glyphs to load at once to do it in parallel, the threads
+ * are created for every load, so only big batches are worth it
+ */
+#define ENESIM_TEXT_FONT_GLYPHS_PARALLEL_THRESHOLD 64
+/* the minimum number of glyphs every thread of a parallel load has */
+#define ENESIM_TEXT_FONT_GLYPHS_PER_WORKER 32
+
+/* the cached glyphs of the BMP are also found on a two level table */
+#define ENESIM_TEXT_FONT_GLYPHS_PAGE_SIZE 256
+#define ENESIM_TEXT_FONT_GLYPHS_PAGES 256
+
 typedef struct _Enesim_Text_Font
 {
 	Enesim_Object_Instance parent;
 	Enesim_Text_Engine *engine;
 	Eina_Hash *glyphs;
+	/* the latin1 page is always allocated, the rest on demand */
+	Enesim_Text_Glyph *latin1[ENESIM_TEXT_FONT_GLYPHS_PAGE_SIZE];
+	Enesim_Text_Glyph **pages[ENESIM_TEXT_FONT_GLYPHS_PAGES];
+	/* the cached glyphs rasterized at a subpixel position */
+	Eina_Hash *variants;
+	/* the glyphs with loaded formats, the most recently used first */
+	Eina_Inlist *lru;
+	size_t memory;
+	size_t budget;
 	char *key;
 	int ref;
 	int cache;
@@ -53,13 +73,22 @@ typedef struct _Enesim_Text_Font_Class
 	int (*max_descent_get)(Enesim_Text_Font *thiz);
 	Enesim_Text_Glyph * (*glyph_get)(Enesim_Text_Font *thiz, Eina_Unicode c);
 	Eina_Bool (*has_kerning)(Enesim_Text_Font *thiz);
+	/* load the formats of several glyphs in parallel, optional */
+	void (*glyphs_load)(Enesim_Text_Font *thiz, Enesim_Text_Glyph **glyphs,
+			int count, int formats);
 } Enesim_Text_Font_Class;
 
 Enesim_Object_Descriptor * enesim_text_font_descriptor_get(void);
 Enesim_Text_Glyph * enesim_text_font_glyph_get(Enesim_Text_Font *f, Eina_Unicode c);
+Enesim_Text_Glyph * enesim_text_font_glyph_variant_get(Enesim_Text_Font *f,
+		Eina_Unicode c, int subpixel);
 Eina_Bool enesim_text_font_has_kerning(Enesim_Text_Font *f);
 void enesim_text_font_glyph_cache(Enesim_Text_Font *thiz, Enesim_Text_Glyph *g);
 void enesim_text_font_glyph_uncache(Enesim_Text_Font *thiz, Enesim_Text_Glyph *g);
+void enesim_text_font_glyph_memory_update(Enesim_Text_Font *thiz,
+		Enesim_Text_Glyph *g, Eina_Bool used);
+void enesim_text_font_glyphs_load(Enesim_Text_Font *thiz,
+		Enesim_Text_Glyph **glyphs, int count, int formats);
 void enesim_text_font_dump(Enesim_Text_Font *f, const char *path);
 
 #endif
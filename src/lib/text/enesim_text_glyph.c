@@ -21,6 +21,7 @@
 
 #include "enesim_text.h"
 #include "enesim_text_private.h"
+#include "enesim_path_private.h"
 /*============================================================================*
  *                                  Local                                     *
  *============================================================================*/
@@ -64,6 +65,11 @@ void enesim_text_glyph_unref(Enesim_Text_Glyph *thiz)
 	thiz->ref--;
 	if (!thiz->ref)
 	{
+		/* remove it from the font accounting */
+		if (thiz->memory)
+			enesim_text_glyph_unload(thiz,
+					ENESIM_TEXT_GLYPH_FORMAT_SURFACE |
+					ENESIM_TEXT_GLYPH_FORMAT_PATH);
 		enesim_text_font_unref(thiz->font);
 		if (thiz->surface)
 		{
@@ -96,21 +102,84 @@ void enesim_text_glyph_uncache(Enesim_Text_Glyph *thiz)
 	enesim_text_glyph_unref(thiz);
 }
 
+/* Only the requested formats are loaded. Every load marks the glyph as
+ * recently used on its font, which might unload the formats of other
+ * unused glyphs to keep the font under its budget
+ */
 Eina_Bool enesim_text_glyph_load(Enesim_Text_Glyph *thiz,
 		int formats)
 {
 	Enesim_Text_Glyph_Class *klass;
+	Eina_Bool ret = EINA_FALSE;
 
 	if (thiz->path && (formats & ENESIM_TEXT_GLYPH_FORMAT_PATH))
 		formats &= ~ENESIM_TEXT_GLYPH_FORMAT_PATH;
 	if (thiz->surface && (formats & ENESIM_TEXT_GLYPH_FORMAT_SURFACE))
 		formats &= ~ENESIM_TEXT_GLYPH_FORMAT_SURFACE;
 	if (!formats)
-		return EINA_TRUE;
+	{
+		ret = EINA_TRUE;
+		goto done;
+	}
+	/* try with the glyphs already rasterized on the engine */
+	formats = enesim_text_engine_glyph_cache_get(thiz->font->engine, thiz,
+			thiz->subpixel, formats);
+	if (!formats)
+	{
+		ret = EINA_TRUE;
+		goto done;
+	}
 	klass = ENESIM_TEXT_GLYPH_CLASS_GET(thiz);
 	if (klass->load)
-		return klass->load(thiz, formats);
-	return EINA_FALSE;
+		ret = klass->load(thiz, formats);
+	if (ret)
+		enesim_text_engine_glyph_cache_add(thiz->font->engine, thiz,
+				thiz->subpixel);
+done:
+	enesim_text_font_glyph_memory_update(thiz->font, thiz, EINA_TRUE);
+	return ret;
+}
+
+/* Release the requested formats, the metrics are kept */
+void enesim_text_glyph_unload(Enesim_Text_Glyph *thiz, int formats)
+{
+	if (thiz->surface && (formats & ENESIM_TEXT_GLYPH_FORMAT_SURFACE))
+	{
+		enesim_surface_unref(thiz->surface);
+		thiz->surface = NULL;
+	}
+	if (thiz->path && (formats & ENESIM_TEXT_GLYPH_FORMAT_PATH))
+	{
+		enesim_path_unref(thiz->path);
+		thiz->path = NULL;
+	}
+	enesim_text_font_glyph_memory_update(thiz->font, thiz, EINA_FALSE);
+}
+
+/* An approximation of the memory used by the loaded formats */
+size_t enesim_text_glyph_memory_get(Enesim_Text_Glyph *thiz)
+{
+	return enesim_text_glyph_formats_memory_get(thiz->surface, thiz->path);
+}
+
+size_t enesim_text_glyph_formats_memory_get(Enesim_Surface *surface,
+		Enesim_Path *path)
+{
+	size_t memory = 0;
+
+	if (surface)
+	{
+		int w, h;
+
+		enesim_surface_size_get(surface, &w, &h);
+		memory += (size_t)w * h * sizeof(uint32_t);
+	}
+	if (path)
+	{
+		memory += eina_list_count(path->commands) *
+				(sizeof(Enesim_Path_Command) + sizeof(Eina_List));
+	}
+	return memory;
 }
 
 double enesim_text_glyph_kerning_get(Enesim_Text_Glyph *thiz, Enesim_Text_Glyph *prev)
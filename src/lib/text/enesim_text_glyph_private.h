@@ -38,6 +38,11 @@
 #define ENESIM_TEXT_GLYPH(o) ENESIM_OBJECT_INSTANCE_CHECK(o, 		\
 		Enesim_Text_Glyph, ENESIM_TEXT_GLYPH_DESCRIPTOR)
 
+/* the number of horizontal subpixel positions a glyph is rasterized at */
+#define ENESIM_TEXT_GLYPH_SUBPIXELS 4
+/* the glyphs are keyed by the code point and the subpixel position */
+#define ENESIM_TEXT_GLYPH_KEY(code, subpixel) (((code) << 2) | (subpixel))
+
 /* forward declarations */
 typedef struct _Enesim_Text_Font Enesim_Text_Font;
 
@@ -52,11 +57,19 @@ typedef struct _Enesim_Text_Glyph
 	Enesim_Path *path;
 	/* the unicode char for this glyph */
 	Eina_Unicode code;
+	/* the surface is shifted subpixel / ENESIM_TEXT_GLYPH_SUBPIXELS
+	 * pixels to the right
+	 */
+	int subpixel;
 	/* temporary */
 	int origin;
 	int x_advance;
 	int ref;
 	int cache;
+	/* the memory used by the loaded formats */
+	size_t memory;
+	/* in case it has memory, its position on the font LRU list */
+	EINA_INLIST;
 } Enesim_Text_Glyph;
 
 typedef struct _Enesim_Text_Glyph_Class
@@ -85,6 +98,10 @@ Enesim_Text_Glyph * enesim_text_glyph_ref(Enesim_Text_Glyph *thiz);
 double enesim_text_glyph_kerning_get(Enesim_Text_Glyph *thiz, Enesim_Text_Glyph *prev);
 void enesim_text_glyph_unref(Enesim_Text_Glyph *thiz);
 Eina_Bool enesim_text_glyph_load(Enesim_Text_Glyph *thiz, int formats);
+void enesim_text_glyph_unload(Enesim_Text_Glyph *thiz, int formats);
+size_t enesim_text_glyph_memory_get(Enesim_Text_Glyph *thiz);
+size_t enesim_text_glyph_formats_memory_get(Enesim_Surface *surface,
+		Enesim_Path *path);
 void enesim_text_glyph_cache(Enesim_Text_Glyph *thiz);
 void enesim_text_glyph_uncache(Enesim_Text_Glyph *thiz);
 
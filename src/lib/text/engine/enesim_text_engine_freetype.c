@@ -81,7 +81,7 @@ static Enesim_Text_Font * _enesim_text_engine_freetype_font_load(
 	FT_Set_Pixel_Sizes(face, size, size);
 	eina_lock_release(&thiz->lock);
 
-	f = enesim_text_font_freetype_new(face);
+	f = enesim_text_font_freetype_new(face, name, index, size);
 
 	return f;
 }
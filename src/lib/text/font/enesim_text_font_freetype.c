@@ -18,8 +18,23 @@
 #include "enesim_private.h"
 
 #include "enesim_main.h"
+#include "enesim_log.h"
+#include "enesim_color.h"
+#include "enesim_rectangle.h"
+#include "enesim_matrix.h"
+#include "enesim_format.h"
+#include "enesim_pool.h"
+#include "enesim_buffer.h"
+#include "enesim_surface.h"
+#include "enesim_renderer.h"
 #include "enesim_text.h"
+#include "enesim_object_descriptor.h"
+#include "enesim_object_class.h"
+#include "enesim_object_instance.h"
+
 #include "enesim_text_private.h"
+#include "enesim_thread_private.h"
+#include "enesim_renderer_private.h"
 
 #if HAVE_FREETYPE
 #include <ft2build.h>
@@ -35,10 +50,36 @@
 #define ENESIM_LOG_DEFAULT enesim_log_text
 
 #if HAVE_FREETYPE
+/* every thread that loads glyphs in parallel has its own library and
+ * face, as those can not be shared between threads
+ */
+typedef struct _Enesim_Text_Font_Freetype_Worker
+{
+	FT_Library library;
+	FT_Face face;
+#ifdef BUILD_MULTI_CORE
+	Enesim_Thread tid;
+#endif
+	/* the glyphs to load, every step glyphs starting at idx */
+	Enesim_Text_Glyph **glyphs;
+	int count;
+	int formats;
+	int idx;
+	int step;
+} Enesim_Text_Font_Freetype_Worker;
+
 typedef struct _Enesim_Text_Font_Freetype
 {
 	Enesim_Text_Font parent;
 	FT_Face face;
+	char *file;
+	int index;
+	int size;
+	/* created on the first parallel load */
+	Enesim_Text_Font_Freetype_Worker *workers;
+	int nworkers;
+	/* the workers are shared by every text span using the font */
+	Eina_Lock workers_lock;
 } Enesim_Text_Font_Freetype;
 
 typedef struct _Enesim_Text_Font_Freetype_Class
@@ -110,6 +151,123 @@ static Eina_Bool _enesim_text_font_freetype_has_kerning(Enesim_Text_Font *f)
  	thiz = ENESIM_TEXT_FONT_FREETYPE(f);
 	return FT_HAS_KERNING(thiz->face);
 }
+
+#ifdef BUILD_MULTI_CORE
+#ifdef _WIN32
+static DWORD WINAPI _enesim_text_font_freetype_worker_run(void *data)
+#else
+static void * _enesim_text_font_freetype_worker_run(void *data)
+#endif
+{
+	Enesim_Text_Font_Freetype_Worker *w = data;
+	int i;
+
+	for (i = w->idx; i < w->count; i += w->step)
+	{
+		enesim_text_glyph_freetype_load_from(w->glyphs[i], w->library,
+				w->face, w->formats);
+	}
+#ifdef _WIN32
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+static Eina_Bool _enesim_text_font_freetype_workers_setup(
+		Enesim_Text_Font_Freetype *thiz)
+{
+	int count;
+	int i;
+
+	if (thiz->workers)
+		return EINA_TRUE;
+	if (!thiz->file)
+		return EINA_FALSE;
+
+	count = enesim_renderer_sw_cpu_count();
+	if (count < 2)
+		return EINA_FALSE;
+
+	thiz->workers = calloc(count, sizeof(Enesim_Text_Font_Freetype_Worker));
+	if (!thiz->workers)
+	{
+		WRN("Impossible to allocate the workers for loading in parallel");
+		return EINA_FALSE;
+	}
+	for (i = 0; i < count; i++)
+	{
+		Enesim_Text_Font_Freetype_Worker *w = &thiz->workers[i];
+
+		if (FT_Init_FreeType(&w->library))
+			break;
+		if (FT_New_Face(w->library, thiz->file, thiz->index, &w->face))
+		{
+			FT_Done_FreeType(w->library);
+			break;
+		}
+		FT_Set_Pixel_Sizes(w->face, thiz->size, thiz->size);
+	}
+	thiz->nworkers = i;
+	if (thiz->nworkers < 2)
+	{
+		WRN("Impossible to create the faces for loading in parallel");
+		for (i = 0; i < thiz->nworkers; i++)
+		{
+			FT_Done_Face(thiz->workers[i].face);
+			FT_Done_FreeType(thiz->workers[i].library);
+		}
+		free(thiz->workers);
+		thiz->workers = NULL;
+		thiz->nworkers = 0;
+		return EINA_FALSE;
+	}
+	return EINA_TRUE;
+}
+
+static void _enesim_text_font_freetype_glyphs_load(Enesim_Text_Font *f,
+		Enesim_Text_Glyph **glyphs, int count, int formats)
+{
+	Enesim_Text_Font_Freetype *thiz;
+	int nworkers;
+	int i;
+
+ 	thiz = ENESIM_TEXT_FONT_FREETYPE(f);
+	eina_lock_take(&thiz->workers_lock);
+	/* the glyphs are loaded later, one by one */
+	if (!_enesim_text_font_freetype_workers_setup(thiz))
+	{
+		eina_lock_release(&thiz->workers_lock);
+		return;
+	}
+
+	/* every thread must have enough glyphs to pay for its creation */
+	nworkers = count / ENESIM_TEXT_FONT_GLYPHS_PER_WORKER;
+	if (nworkers > thiz->nworkers)
+		nworkers = thiz->nworkers;
+	if (nworkers < 2)
+	{
+		eina_lock_release(&thiz->workers_lock);
+		return;
+	}
+
+	for (i = 0; i < nworkers; i++)
+	{
+		Enesim_Text_Font_Freetype_Worker *w = &thiz->workers[i];
+
+		w->glyphs = glyphs;
+		w->count = count;
+		w->formats = formats;
+		w->idx = i;
+		w->step = nworkers;
+		enesim_thread_new(&w->tid,
+				_enesim_text_font_freetype_worker_run, w);
+	}
+	for (i = 0; i < nworkers; i++)
+		enesim_thread_free(thiz->workers[i].tid);
+	eina_lock_release(&thiz->workers_lock);
+}
+#endif
 /*----------------------------------------------------------------------------*
  *                            Object definition                               *
  *----------------------------------------------------------------------------*/
@@ -124,23 +282,40 @@ static void _enesim_text_font_freetype_class_init(void *k)
 	klass->max_descent_get = _enesim_text_font_freetype_max_descent_get;
 	klass->glyph_get = _enesim_text_font_freetype_glyph_get;
 	klass->has_kerning = _enesim_text_font_freetype_has_kerning;
+#ifdef BUILD_MULTI_CORE
+	klass->glyphs_load = _enesim_text_font_freetype_glyphs_load;
+#endif
 }
 
-static void _enesim_text_font_freetype_instance_init(void *o EINA_UNUSED)
+static void _enesim_text_font_freetype_instance_init(void *o)
 {
+	Enesim_Text_Font_Freetype *thiz = o;
+
+	eina_lock_new(&thiz->workers_lock);
 }
 
 static void _enesim_text_font_freetype_instance_deinit(void *o)
 {
 	Enesim_Text_Font_Freetype *thiz = o;
+	int i;
+
 	/* TODO lock the engine, check that we still have it */
 	FT_Done_Face(thiz->face);
+	for (i = 0; i < thiz->nworkers; i++)
+	{
+		FT_Done_Face(thiz->workers[i].face);
+		FT_Done_FreeType(thiz->workers[i].library);
+	}
+	free(thiz->workers);
+	free(thiz->file);
+	eina_lock_free(&thiz->workers_lock);
 }
 #endif
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
-Enesim_Text_Font * enesim_text_font_freetype_new(FT_Face face)
+Enesim_Text_Font * enesim_text_font_freetype_new(FT_Face face,
+		const char *file, int index, int size)
 {
 	Enesim_Text_Font_Freetype *thiz;
 	Enesim_Text_Font *f;
@@ -148,6 +323,11 @@ Enesim_Text_Font * enesim_text_font_freetype_new(FT_Face face)
 	f = ENESIM_OBJECT_INSTANCE_NEW(enesim_text_font_freetype);
 	thiz = ENESIM_TEXT_FONT_FREETYPE(f);
 	thiz->face = face;
+	/* keep the origin of the face to open it again on other threads */
+	if (file)
+		thiz->file = strdup(file);
+	thiz->index = index;
+	thiz->size = size;
 
 	return f;
 }
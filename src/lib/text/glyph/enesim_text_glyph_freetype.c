@@ -54,6 +54,8 @@ typedef struct _Enesim_Text_Glyph_Freetype_Load_Data
 {
 	FT_GlyphSlot glyph;
 	Enesim_Buffer_Sw_Data *data;
+	int width;
+	int height;
 } Enesim_Text_Glyph_Freetype_Load_Data;
 
 static void _raster_callback(const int y,
@@ -66,28 +68,32 @@ static void _raster_callback(const int y,
 	int ry;
 	uint32_t *yptr;
 
-#if 0
-	int width;
-	int height;
-	/* get the real y */
-	width = efg->glyph->metrics.width >> 6;
-	height = efg->glyph->metrics.height >> 6;
-#endif
-
 	ry = (efg->glyph->metrics.horiBearingY >> 6) - y - 1;
+	/* the rounding of the metrics might leave some span outside */
+	if (ry < 0 || ry >= efg->height)
+		return;
 	yptr = (uint32_t *)((uint8_t *)efg->data->argb8888_pre.plane0 + (ry * efg->data->argb8888_pre.plane0_stride));
 	for (i = 0; i < count; i++)
 	{
 		int x;
 		int rx;
+		int len;
 		uint32_t *xptr;
 		uint8_t a;
 
 		/* get the real x */
 		rx = spans[i].x - (efg->glyph->metrics.horiBearingX >> 6);
+		len = spans[i].len;
+		if (rx < 0)
+		{
+			len += rx;
+			rx = 0;
+		}
+		if (rx + len > efg->width)
+			len = efg->width - rx;
 		a = spans[i].coverage;
 		xptr = yptr + rx;
-		for (x = 0; x < spans[i].len; x++)
+		for (x = 0; x < len; x++)
 		{
 			*xptr = a << 24 | a << 16 | a << 8 | a;
 			xptr++;
@@ -95,22 +101,31 @@ static void _raster_callback(const int y,
 	}
 }
 
+static void _enesim_text_glyph_freetype_surface_free(void *data,
+		void *user_data EINA_UNUSED)
+{
+	free(data);
+}
+
 static void _enesim_text_glyph_freetype_load_surface(Enesim_Text_Glyph *g,
-		FT_GlyphSlot glyph)
+		FT_Library lib, FT_GlyphSlot glyph)
 {
 	Enesim_Text_Glyph_Freetype_Load_Data efg;
 	Enesim_Buffer_Sw_Data sdata;
-	FT_Library lib;
 	FT_Outline *outline = &glyph->outline;
 	FT_Raster_Params params;
 	unsigned int width, height;
 	void *gdata;
 
-	lib = enesim_text_engine_freetype_lib_get(g->font->engine);
 	width = glyph->metrics.width >> 6;
 	height = glyph->metrics.height >> 6;
 	if (!width || !height)
 		return;
+	/* the outline shifted to the subpixel position might cover one more
+	 * pixel column
+	 */
+	if (g->subpixel)
+		width++;
 
 	gdata = calloc(width * height, sizeof(uint32_t));
 
@@ -119,17 +134,22 @@ static void _enesim_text_glyph_freetype_load_surface(Enesim_Text_Glyph *g,
 
 	efg.data = &sdata;
 	efg.glyph = glyph;
+	efg.width = width;
+	efg.height = height;
 
 	memset(&params, 0, sizeof(params));
 	params.flags = FT_RASTER_FLAG_AA | FT_RASTER_FLAG_DIRECT;
 	params.gray_spans = _raster_callback;
 	params.user = &efg;
 
+	/* the outline is in 26.6 fixed point */
+	FT_Outline_Translate(outline, g->subpixel * 64 / ENESIM_TEXT_GLYPH_SUBPIXELS, 0);
 	FT_Outline_Render(lib, outline, &params);
+	FT_Outline_Translate(outline, -g->subpixel * 64 / ENESIM_TEXT_GLYPH_SUBPIXELS, 0);
 	g->surface = enesim_surface_new_data_from(
 			ENESIM_FORMAT_ARGB8888, width, height,
-			EINA_FALSE, gdata, width * 4, NULL,
-			NULL);
+			EINA_FALSE, gdata, width * 4,
+			_enesim_text_glyph_freetype_surface_free, NULL);
 }
 
 static Eina_Bool _enesim_text_glyph_freetype_load_path(Enesim_Text_Glyph *g,
@@ -322,30 +342,13 @@ bad_outline:
 static Eina_Bool _enesim_text_glyph_freetype_load(Enesim_Text_Glyph *g,
 		int formats)
 {
-	Enesim_Text_Glyph_Freetype *thiz;
+	FT_Library lib;
 	FT_Face face;
 
 	enesim_text_engine_freetype_lock(g->font->engine);
 	face = enesim_text_font_freetype_face_get(g->font);
-
-	thiz = ENESIM_TEXT_GLYPH_FREETYPE(g);
-	if (!FT_Load_Glyph(face, thiz->index, FT_LOAD_NO_BITMAP))
-	{
-		if (face->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
-		{
-			g->origin = (face->glyph->metrics.horiBearingY >> 6);
-			g->x_advance = (face->glyph->metrics.horiAdvance >> 6);
-			if (formats & ENESIM_TEXT_GLYPH_FORMAT_SURFACE)
-			{
-				_enesim_text_glyph_freetype_load_surface(g, face->glyph);
-			}
-
-			if (formats & ENESIM_TEXT_GLYPH_FORMAT_PATH)
-			{
-				_enesim_text_glyph_freetype_load_path(g, face->glyph);
-			}
-		}
-	}
+	lib = enesim_text_engine_freetype_lib_get(g->font->engine);
+	enesim_text_glyph_freetype_load_from(g, lib, face, formats);
 	enesim_text_engine_freetype_unlock(g->font->engine);
 	return EINA_TRUE;
 }
@@ -394,6 +397,33 @@ static void _enesim_text_glyph_freetype_instance_deinit(void *o EINA_UNUSED)
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
+/* Load the glyph formats using the library and face passed in. The caller
+ * must guarantee that no other thread uses them at the same time
+ */
+void enesim_text_glyph_freetype_load_from(Enesim_Text_Glyph *g,
+		FT_Library lib, FT_Face face, int formats)
+{
+	Enesim_Text_Glyph_Freetype *thiz;
+
+	thiz = ENESIM_TEXT_GLYPH_FREETYPE(g);
+	if (FT_Load_Glyph(face, thiz->index, FT_LOAD_NO_BITMAP))
+		return;
+	if (face->glyph->format != FT_GLYPH_FORMAT_OUTLINE)
+		return;
+
+	g->origin = (face->glyph->metrics.horiBearingY >> 6);
+	g->x_advance = (face->glyph->metrics.horiAdvance >> 6);
+	if ((formats & ENESIM_TEXT_GLYPH_FORMAT_SURFACE) && !g->surface)
+	{
+		_enesim_text_glyph_freetype_load_surface(g, lib, face->glyph);
+	}
+
+	if ((formats & ENESIM_TEXT_GLYPH_FORMAT_PATH) && !g->path)
+	{
+		_enesim_text_glyph_freetype_load_path(g, face->glyph);
+	}
+}
+
 Enesim_Text_Glyph * enesim_text_glyph_freetype_new(FT_UInt index)
 {
 	Enesim_Text_Glyph_Freetype *thiz;
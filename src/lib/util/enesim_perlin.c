@@ -99,6 +99,23 @@ static Eina_F16p16 interpolatenoise(Eina_F16p16 x, Eina_F16p16 y)
 	return _f16p16_interpolate(fy, v2, v1);
 }
 
+static inline int _wrap(int i, int period)
+{
+	if (!period)
+		return i;
+	i %= period;
+	if (i < 0)
+		i += period;
+	return i;
+}
+
+/* the noise of a lattice column interpolated at the y position */
+static inline Eina_F16p16 _column_get(int ix, int iy0, int iy1, Eina_F16p16 fy,
+		int xperiod)
+{
+	ix = _wrap(ix, xperiod);
+	return _f16p16_interpolate(fy, noise(ix, iy1), noise(ix, iy0));
+}
 /*============================================================================*
  *                                 Global                                     *
  *============================================================================*/
@@ -126,6 +143,100 @@ Eina_F16p16 enesim_perlin_get(Eina_F16p16 xx, Eina_F16p16 yy,
 	return total;
 }
 
+/* Accumulate the noise of a horizontal span of pixels starting at xx, yy
+ * on dst, already normalized to the -1,1 range. The y position is the same
+ * for the whole span, so every octave interpolates the lattice columns
+ * vertically just once and keeps the two columns of the current cell while
+ * walking over it. That way the noise is calculated twice per cell instead
+ * of four times per pixel. In case the periods are set, the lattice wraps
+ * at them, see enesim_perlin_tile_coeff_set()
+ */
+void enesim_perlin_span_get(Eina_F16p16 xx, Eina_F16p16 yy, int len,
+	unsigned int octaves, Eina_F16p16 *xfreq, Eina_F16p16 *yfreq,
+	Eina_F16p16 *ampl, const int *xperiods, const int *yperiods,
+	Eina_F16p16 *dst)
+{
+	unsigned int i;
+	Eina_F16p16 max = 0;
+	int k;
+
+	for (i = 0; i < octaves; i++)
+		max += ampl[i];
+	for (k = 0; k < len; k++)
+		dst[k] = 0;
+	if (!max)
+		return;
+
+	for (i = 0; i < octaves; i++)
+	{
+		Eina_F16p16 x, y, fy;
+		Eina_F16p16 c0, c1;
+		Eina_F16p16 a;
+		int xperiod = xperiods ? xperiods[i] : 0;
+		int iy, iy0, iy1;
+		int cell;
+
+		/* normalize the amplitude once instead of the total per pixel */
+		a = eina_f16p16_div(ampl[i], max);
+		x = eina_f16p16_mul(xx, xfreq[i]);
+		y = eina_f16p16_mul(yy, yfreq[i]);
+		fy = eina_f16p16_fracc_get(y);
+		iy = eina_f16p16_int_to(y);
+		iy0 = _wrap(iy, yperiods ? yperiods[i] : 0);
+		iy1 = _wrap(iy + 1, yperiods ? yperiods[i] : 0);
+
+		cell = eina_f16p16_int_to(x);
+		c0 = _column_get(cell, iy0, iy1, fy, xperiod);
+		c1 = _column_get(cell + 1, iy0, iy1, fy, xperiod);
+		for (k = 0; k < len; k++)
+		{
+			Eina_F16p16 res;
+			int ix;
+
+			ix = eina_f16p16_int_to(x);
+			if (ix != cell)
+			{
+				if (ix == cell + 1)
+					c0 = c1;
+				else
+					c0 = _column_get(ix, iy0, iy1, fy, xperiod);
+				c1 = _column_get(ix + 1, iy0, iy1, fy, xperiod);
+				cell = ix;
+			}
+			res = _f16p16_interpolate(eina_f16p16_fracc_get(x), c1, c0);
+			dst[k] += eina_f16p16_mul(res, a);
+			/* the pixels are one unit apart */
+			x += xfreq[i];
+		}
+	}
+}
+
+/* Round the frequencies of every octave so the noise of a tile of size
+ * pixels fits an integer number of lattice cells. The periods the lattice
+ * must wrap at for the tile to be seamless are returned
+ */
+void enesim_perlin_tile_coeff_set(unsigned int octaves, int size,
+	Eina_F16p16 *xfreqcoeff, Eina_F16p16 *yfreqcoeff,
+	int *xperiods, int *yperiods)
+{
+	unsigned int i;
+
+	for (i = 0; i < octaves; i++)
+	{
+		int p;
+
+		p = (int)(eina_f16p16_double_to(xfreqcoeff[i]) * size + 0.5);
+		if (p < 1) p = 1;
+		xperiods[i] = p;
+		xfreqcoeff[i] = eina_f16p16_double_from((double)p / size);
+
+		p = (int)(eina_f16p16_double_to(yfreqcoeff[i]) * size + 0.5);
+		if (p < 1) p = 1;
+		yperiods[i] = p;
+		yfreqcoeff[i] = eina_f16p16_double_from((double)p / size);
+	}
+}
+
 void enesim_perlin_coeff_set(unsigned int octaves, double persistence,
 	double xfreq, double yfreq, double amplitude, Eina_F16p16 *xfreqcoeff,
 	Eina_F16p16 *yfreqcoeff, Eina_F16p16 *amplcoeff)
@@ -21,8 +21,15 @@
 Eina_F16p16 enesim_perlin_get(Eina_F16p16 xx, Eina_F16p16 yy,
 	unsigned int octaves, Eina_F16p16 *xfreq, Eina_F16p16 *yfreq,
 	Eina_F16p16 *ampl);
+void enesim_perlin_span_get(Eina_F16p16 xx, Eina_F16p16 yy, int len,
+	unsigned int octaves, Eina_F16p16 *xfreq, Eina_F16p16 *yfreq,
+	Eina_F16p16 *ampl, const int *xperiods, const int *yperiods,
+	Eina_F16p16 *dst);
 void enesim_perlin_coeff_set(unsigned int octaves, double persistence,
 	double xfreq, double yfreq, double amplitude, Eina_F16p16 *xfreqcoeff,
 	Eina_F16p16 *yfreqcoeff, Eina_F16p16 *amplcoeff);
+void enesim_perlin_tile_coeff_set(unsigned int octaves, int size,
+	Eina_F16p16 *xfreqcoeff, Eina_F16p16 *yfreqcoeff,
+	int *xperiods, int *yperiods);
 
 #endif /*ENESIM_PERLIN_H_*/
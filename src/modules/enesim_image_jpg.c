@@ -43,6 +43,7 @@ struct _Jpg_Source
 	struct jpeg_source_mgr pub;
 	JOCTET buffer[JPG_BLOCK_SIZE];
 	Eina_Bool mmaped;
+	void *map;
 	Enesim_Stream *data;
 };
 
@@ -54,6 +55,9 @@ struct _Jpg_Error_Mgr
 
 static int enesim_image_log_dom_jpg = -1;
 
+/* the marker to feed the decoder with whenever the data ends prematurely */
+static const JOCTET _jpg_eoi[2] = { 0xff, JPEG_EOI };
+
 static void _jpg_error_exit_cb(j_common_ptr cinfo)
 {
 	Jpg_Error_Mgr *err;
@@ -76,24 +80,27 @@ static const char * _jpg_name_get(void)
 	return "jpg";
 }
 
-static void _jpg_enesim_image_src_init(j_decompress_ptr cinfo)
+static void _jpg_enesim_image_src_init(j_decompress_ptr cinfo EINA_UNUSED)
 {
-	/* TODO check if we can mmap the buffer, if so map it and use
-	 * directly the whole bytes and pointer
+	/* in case the stream is mapped, the whole data is already in the
+	 * buffer, otherwise it is read on the first fill
 	 */
-	cinfo->src->bytes_in_buffer = 0;
 }
 
 static boolean _jpg_enesim_image_src_fill(j_decompress_ptr cinfo)
 {
 	Jpg_Source *thiz = (Jpg_Source *)cinfo->src;
-	ssize_t ret;
+	ssize_t ret = 0;
 
-	ret = enesim_stream_read(thiz->data, thiz->buffer, JPG_BLOCK_SIZE);
+	/* the mapped data is given at once, so there is nothing else to read */
+	if (!thiz->mmaped)
+		ret = enesim_stream_read(thiz->data, thiz->buffer, JPG_BLOCK_SIZE);
 	if (ret <= 0)
 	{
-		ERR("Reading failed");
-		ret = 0;
+		WRN("Premature end of data");
+		thiz->pub.next_input_byte = _jpg_eoi;
+		thiz->pub.bytes_in_buffer = sizeof(_jpg_eoi);
+		return TRUE;
 	}
 
 	thiz->pub.bytes_in_buffer = ret;
@@ -127,6 +134,7 @@ static void _jpg_enesim_image_src_term(j_decompress_ptr cinfo EINA_UNUSED)
 static void _jpg_enesim_image_src(struct jpeg_decompress_struct *cinfo, Enesim_Stream *data)
 {
 	Jpg_Source *thiz;
+	size_t size;
 
 	thiz = calloc(1, sizeof(Jpg_Source));
 	thiz->data = data;
@@ -139,8 +147,32 @@ static void _jpg_enesim_image_src(struct jpeg_decompress_struct *cinfo, Enesim_S
 	thiz->pub.bytes_in_buffer = 0;
 	thiz->pub.next_input_byte = NULL;
 
+	/* decode directly from the stream memory in case it can be mapped */
+	thiz->map = enesim_stream_mmap(data, &size);
+	if (thiz->map)
+	{
+		thiz->mmaped = EINA_TRUE;
+		thiz->pub.next_input_byte = thiz->map;
+		thiz->pub.bytes_in_buffer = size;
+	}
+
 	cinfo->src = (struct jpeg_source_mgr *)thiz;
 }
+
+/* the source is not part of the decompress struct, so it needs to be
+ * released before destroying it
+ */
+static void _jpg_enesim_image_src_free(struct jpeg_decompress_struct *cinfo)
+{
+	Jpg_Source *thiz = (Jpg_Source *)cinfo->src;
+
+	if (!thiz)
+		return;
+	if (thiz->mmaped)
+		enesim_stream_munmap(thiz->data, thiz->map);
+	free(thiz);
+	cinfo->src = NULL;
+}
 /*----------------------------------------------------------------------------*
  *                         Enesim Image Provider API                          *
  *----------------------------------------------------------------------------*/
@@ -159,6 +191,7 @@ static Eina_Bool _jpg_info_get(Enesim_Stream *data, int *w, int *h,
 	err.pub.error_exit = _jpg_error_exit_cb;
 	if (setjmp(err.setjmp_buffer))
 	{
+		_jpg_enesim_image_src_free(&cinfo);
 		jpeg_destroy_decompress(&cinfo);
 		*error = ENESIM_IMAGE_ERROR_ALLOCATOR;
 		return EINA_FALSE;
@@ -210,6 +243,7 @@ static Eina_Bool _jpg_info_get(Enesim_Stream *data, int *w, int *h,
 		fmt = ENESIM_BUFFER_FORMAT_GRAY;
 	else
 	{
+		_jpg_enesim_image_src_free(&cinfo);
 		jpeg_destroy_decompress(&cinfo);
 		*error = ENESIM_IMAGE_ERROR_FORMAT;
 		return EINA_FALSE;
@@ -219,6 +253,7 @@ static Eina_Bool _jpg_info_get(Enesim_Stream *data, int *w, int *h,
 	if (h) *h = hh;
 	if (sfmt) *sfmt = fmt;
 
+	_jpg_enesim_image_src_free(&cinfo);
 	jpeg_destroy_decompress(&cinfo);
 	return EINA_TRUE;
 }
@@ -239,6 +274,7 @@ static Eina_Bool _jpg_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 	err.pub.error_exit = _jpg_error_exit_cb;
 	if (setjmp(err.setjmp_buffer))
 	{
+		_jpg_enesim_image_src_free(&cinfo);
 		jpeg_destroy_decompress(&cinfo);
 		*error = ENESIM_IMAGE_ERROR_ALLOCATOR;
 		return EINA_FALSE;
@@ -292,6 +328,7 @@ static Eina_Bool _jpg_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 		break;
 
 		default:
+		_jpg_enesim_image_src_free(&cinfo);
 		jpeg_destroy_decompress(&cinfo);
 		*error = ENESIM_IMAGE_ERROR_FORMAT;
 		return EINA_FALSE;
@@ -304,6 +341,7 @@ static Eina_Bool _jpg_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 		jpeg_read_scanlines(&cinfo, &row, 1);
 		line += stride;
 	}
+	_jpg_enesim_image_src_free(&cinfo);
 	jpeg_destroy_decompress(&cinfo);
 	return EINA_TRUE;
 }
@@ -395,6 +433,8 @@ static Eina_Bool enesim_image_jpg_provider_init(void)
 		enesim_image_provider_unregister(&_provider, "image/jpg");
 		return EINA_FALSE;
 	}
+	enesim_image_finder_magic_register(&_finder, "image/jpg",
+			"\xff\xd8\xff", 3, 0);
 	return EINA_TRUE;
 }
 
@@ -3,6 +3,7 @@
 #endif
 
 #include <stdio.h>
+#include <string.h>
 
 #include "Enesim.h"
 #include "png.h"
@@ -33,6 +34,15 @@
 #endif
 #define DBG(...) EINA_LOG_DOM_DBG(enesim_image_log_dom_png, __VA_ARGS__)
 
+typedef struct _Png_Source
+{
+	Enesim_Stream *data;
+	/* in case the stream can be mapped, read from it directly */
+	uint8_t *map;
+	size_t size;
+	size_t off;
+} Png_Source;
+
 static int enesim_image_log_dom_png = -1;
 
 static void _png_msg_error_cb(png_structp png_ptr EINA_UNUSED, png_const_charp error_msg)
@@ -76,13 +86,37 @@ static Eina_Bool _png_format_get(int color_type, Enesim_Buffer_Format *fmt)
 	return EINA_TRUE;
 }
 
+static void _png_source_init(Png_Source *thiz, Enesim_Stream *data)
+{
+	thiz->data = data;
+	thiz->off = 0;
+	thiz->map = enesim_stream_mmap(data, &thiz->size);
+}
+
+static void _png_source_shutdown(Png_Source *thiz)
+{
+	if (thiz->map)
+		enesim_stream_munmap(thiz->data, thiz->map);
+}
+
 /* our own io functions */
 static void _png_read(png_structp png_ptr, png_bytep buf, png_size_t length)
 {
-	Enesim_Stream *data;
+	Png_Source *thiz;
 
-	data = png_get_io_ptr(png_ptr);
-	enesim_stream_read(data, buf, length);
+	thiz = png_get_io_ptr(png_ptr);
+	if (!thiz->map)
+	{
+		enesim_stream_read(thiz->data, buf, length);
+		return;
+	}
+	/* libpng always asks for its own buffers to be filled, at least
+	 * avoid the copies and calls of the stream reading
+	 */
+	if (length > thiz->size - thiz->off)
+		png_error(png_ptr, "Read past the end of the stream");
+	memcpy(buf, thiz->map + thiz->off, length);
+	thiz->off += length;
 }
 
 static void _png_write(png_structp png_ptr, png_bytep buf, png_size_t length)
@@ -114,11 +148,13 @@ static Eina_Bool _png_info_get(Enesim_Stream *data, int *w, int *h,
 		Enesim_Buffer_Format *sfmt, void *options EINA_UNUSED,
 		Eina_Error *err)
 {
+	Png_Source src;
 	png_uint_32 w32, h32;
 	png_structp png_ptr = NULL;
 	png_infop info_ptr = NULL;
 	int bit_depth, color_type, interlace_type;
 
+	_png_source_init(&src, data);
 	png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL,
 	_png_msg_error_cb, _png_msg_warning_cb);
 	if (!png_ptr)
@@ -131,7 +167,7 @@ static Eina_Bool _png_info_get(Enesim_Stream *data, int *w, int *h,
 	if (setjmp(png_jmpbuf(png_ptr)))
 		goto error_jmp;
 
-	png_set_read_fn(png_ptr,(png_voidp)data, _png_read);
+	png_set_read_fn(png_ptr,(png_voidp)&src, _png_read);
 	png_read_info(png_ptr, info_ptr);
 	png_get_IHDR(png_ptr, info_ptr, (png_uint_32 *) (&w32),
 			(png_uint_32 *) (&h32), &bit_depth, &color_type,
@@ -148,6 +184,7 @@ static Eina_Bool _png_info_get(Enesim_Stream *data, int *w, int *h,
 	}
 
 	png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+	_png_source_shutdown(&src);
 	return EINA_TRUE;
 
 error_jmp:
@@ -155,6 +192,7 @@ error_jmp:
 error_info_struct:
 	png_destroy_read_struct(&png_ptr, NULL, NULL);
 error_read_struct:
+	_png_source_shutdown(&src);
 	*err = ENESIM_IMAGE_ERROR_LOADING;
 	return EINA_FALSE;
 }
@@ -164,6 +202,7 @@ static Eina_Bool _png_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 {
 	Enesim_Buffer_Sw_Data sw_data;
 	Enesim_Buffer_Format fmt;
+	Png_Source src;
 	png_uint_32 w32, h32;
 	png_structp png_ptr = NULL;
 	png_infop info_ptr = NULL;
@@ -180,6 +219,7 @@ static Eina_Bool _png_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 	hasa = 0;
 	hasg = 0;
 
+	_png_source_init(&src, data);
 	png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL,
 			NULL);
 	if (!png_ptr)
@@ -192,7 +232,7 @@ static Eina_Bool _png_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 	if (setjmp(png_jmpbuf(png_ptr)))
 		goto error_jmp;
 
-	png_set_read_fn(png_ptr,(png_voidp)data, _png_read);
+	png_set_read_fn(png_ptr,(png_voidp)&src, _png_read);
 	png_read_info(png_ptr, info_ptr);
 	png_get_IHDR(png_ptr, info_ptr, (png_uint_32 *) (&w32),
 			(png_uint_32 *) (&h32), &bit_depth, &color_type,
@@ -250,13 +290,14 @@ static Eina_Bool _png_load(Enesim_Stream *data, Enesim_Buffer *buffer,
 	/* setup the pointers */
 	for (i = 0; i < h32; i++)
 	{
-		lines[i] = ((unsigned char *)(sdata)) + (i * w32
-				* pixel_inc);
+		lines[i] = ((unsigned char *)(sdata)) + (i *
+				sw_data.argb8888.plane0_stride);
 	}
 	png_read_image(png_ptr, lines);
 	png_read_end(png_ptr, info_ptr);
 
 	png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+	_png_source_shutdown(&src);
 	return EINA_TRUE;
 
 error_jmp:
@@ -264,6 +305,7 @@ error_jmp:
 error_info_struct:
 	png_destroy_read_struct(&png_ptr, NULL, NULL);
 error_read_struct:
+	_png_source_shutdown(&src);
 	*err = ENESIM_IMAGE_ERROR_LOADING;
 	return EINA_FALSE;
 }
@@ -343,7 +385,7 @@ static Eina_Bool _png_save(Enesim_Stream *data, Enesim_Buffer *b,
 	for (y = 0; y < h; y++)
 	{
 		png_write_rows(png_ptr, &row_ptr, 1);
-		row_ptr += w * 4;
+		row_ptr += cdata.argb8888.plane0_stride;
 	}
 	png_write_end(png_ptr, info_ptr);
 
@@ -426,6 +468,8 @@ static Eina_Bool enesim_image_png_provider_init(void)
 		enesim_image_provider_unregister(&_provider, "image/png");
 		return EINA_FALSE;
 	}
+	enesim_image_finder_magic_register(&_finder, "image/png",
+			"\x89PNG\r\n\x1a\n", 8, 0);
 	return EINA_TRUE;
 }
 
@@ -77,12 +77,12 @@ static Eina_Bool _raw_save(Enesim_Stream *data, Enesim_Buffer *buffer,
 	 */
 	enesim_buffer_sw_data_get(buffer, &sdata);
 	enesim_buffer_size_get(buffer, &w, &h);
-	src = sdata.argb8888_pre.plane0;
 	stride = sdata.argb8888_pre.plane0_stride;
 
 	enesim_stream_write(data, (void *)str_data, strlen(str_data));
 	for (i = 0; i < h; i++)
 	{
+		src = (uint32_t *)((uint8_t *)sdata.argb8888_pre.plane0 + i * stride);
 		for (j = 0; j < w; j++)
 		{
 			char str[255];
@@ -99,7 +99,6 @@ static Eina_Bool _raw_save(Enesim_Stream *data, Enesim_Buffer *buffer,
 			cols++;
 			src++;
 		}
-		src = (uint32_t *)((uint8_t *)src + stride);
 	}
 	enesim_stream_write(data, "\n};\n", 4);
 	/* now the function to get such surface */
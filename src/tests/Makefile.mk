@@ -11,8 +11,11 @@ $(top_builddir)/src/lib/libenesim.la \
 
 check_PROGRAMS = \
 src/tests/enesim_test_eina_pool \
+src/tests/enesim_test_recycle_pool \
+src/tests/enesim_test_image_providers \
 src/tests/enesim_test_renderer \
 src/tests/enesim_test_renderer_error \
+src/tests/enesim_test_renderer_runs \
 src/tests/enesim_test_object01 \
 src/tests/enesim_test_damages
 
@@ -31,6 +34,14 @@ src_tests_enesim_test_eina_pool_SOURCES = src/tests/enesim_test_eina_pool.c
 src_tests_enesim_test_eina_pool_LDADD = $(tests_LDADD)
 src_tests_enesim_test_eina_pool_CPPFLAGS = $(tests_CPPFLAGS)
 
+src_tests_enesim_test_recycle_pool_SOURCES = src/tests/enesim_test_recycle_pool.c
+src_tests_enesim_test_recycle_pool_LDADD = $(tests_LDADD)
+src_tests_enesim_test_recycle_pool_CPPFLAGS = $(tests_CPPFLAGS)
+
+src_tests_enesim_test_image_providers_SOURCES = src/tests/enesim_test_image_providers.c
+src_tests_enesim_test_image_providers_LDADD = $(tests_LDADD)
+src_tests_enesim_test_image_providers_CPPFLAGS = $(tests_CPPFLAGS)
+
 src_tests_enesim_test_renderer_SOURCES = src/tests/enesim_test_renderer.c
 src_tests_enesim_test_renderer_LDADD = $(tests_LDADD)
 src_tests_enesim_test_renderer_CPPFLAGS = $(tests_CPPFLAGS)
@@ -39,6 +50,10 @@ src_tests_enesim_test_renderer_error_SOURCES = src/tests/enesim_test_renderer_er
 src_tests_enesim_test_renderer_error_LDADD = $(tests_LDADD)
 src_tests_enesim_test_renderer_error_CPPFLAGS = $(tests_CPPFLAGS)
 
+src_tests_enesim_test_renderer_runs_SOURCES = src/tests/enesim_test_renderer_runs.c
+src_tests_enesim_test_renderer_runs_LDADD = $(tests_LDADD)
+src_tests_enesim_test_renderer_runs_CPPFLAGS = $(tests_CPPFLAGS)
+
 src_tests_enesim_test_damages_SOURCES = src/tests/enesim_test_damages.c
 src_tests_enesim_test_damages_LDADD = $(tests_LDADD)
 src_tests_enesim_test_damages_CPPFLAGS = $(tests_CPPFLAGS)
@@ -0,0 +1,146 @@
+#include <string.h>
+#include "Enesim.h"
+
+#define TEST_MIME "image/x-enesim-test"
+
+static const char * _name_get(void)
+{
+	return "test";
+}
+
+static Eina_Bool _primary_info_get(Enesim_Stream *data, int *w, int *h,
+		Enesim_Buffer_Format *sfmt, void *options, Eina_Error *err)
+{
+	*w = 1;
+	return EINA_TRUE;
+}
+
+static Eina_Bool _marginal_info_get(Enesim_Stream *data, int *w, int *h,
+		Enesim_Buffer_Format *sfmt, void *options, Eina_Error *err)
+{
+	*w = 2;
+	return EINA_TRUE;
+}
+
+static Eina_Bool _load(Enesim_Stream *data, Enesim_Buffer *b, void *options,
+		Eina_Error *err)
+{
+	return EINA_FALSE;
+}
+
+static Enesim_Image_Provider_Descriptor _primary = {
+	/* .version_get =	*/ NULL,
+	/* .name_get = 		*/ _name_get,
+	/* .options_parse =	*/ NULL,
+	/* .options_free =	*/ NULL,
+	/* .loadable = 		*/ NULL,
+	/* .saveable = 		*/ NULL,
+	/* .info_get = 		*/ _primary_info_get,
+	/* .formats_get =	*/ NULL,
+	/* .load = 		*/ _load,
+	/* .save = 		*/ NULL,
+};
+
+static Enesim_Image_Provider_Descriptor _marginal = {
+	/* .version_get =	*/ NULL,
+	/* .name_get = 		*/ _name_get,
+	/* .options_parse =	*/ NULL,
+	/* .options_free =	*/ NULL,
+	/* .loadable = 		*/ NULL,
+	/* .saveable = 		*/ NULL,
+	/* .info_get = 		*/ _marginal_info_get,
+	/* .formats_get =	*/ NULL,
+	/* .load = 		*/ _load,
+	/* .save = 		*/ NULL,
+};
+
+static Enesim_Image_Finder_Descriptor _finder = {
+	/* .version_get =	*/ NULL,
+	/* .data_from = 	*/ NULL,
+	/* .extension_from =	*/ NULL,
+};
+
+/* the provider with the lowest priority must be the last one, no matter
+ * the order they are registered in
+ */
+static int _test_priority(Enesim_Image_Provider_Descriptor *first,
+		Enesim_Image_Provider_Descriptor *second)
+{
+	Enesim_Stream *s;
+	char data[] = "test";
+	int w = 0;
+	int h = 0;
+
+	enesim_image_provider_register(first, first == &_primary ?
+			ENESIM_PRIORITY_PRIMARY : ENESIM_PRIORITY_MARGINAL,
+			TEST_MIME);
+	enesim_image_provider_register(second, second == &_primary ?
+			ENESIM_PRIORITY_PRIMARY : ENESIM_PRIORITY_MARGINAL,
+			TEST_MIME);
+
+	s = enesim_stream_buffer_new(data, sizeof(data), NULL);
+	enesim_image_info_get(s, TEST_MIME, &w, &h, NULL, NULL, NULL);
+	enesim_stream_unref(s);
+
+	enesim_image_provider_unregister(first, TEST_MIME);
+	enesim_image_provider_unregister(second, TEST_MIME);
+
+	if (w != 1)
+	{
+		printf("Wrong provider used, the marginal one is not the last\n");
+		return 1;
+	}
+	return 0;
+}
+
+/* the longest magic number that matches must win */
+static int _test_magic(void)
+{
+	Enesim_Stream *s;
+	const char *mime;
+	char data[] = "ENESIMTEST";
+	int ret = 0;
+
+	enesim_image_finder_register(&_finder);
+	enesim_image_finder_magic_register(&_finder, "image/x-enesim-short",
+			"ENES", 4, 0);
+	enesim_image_finder_magic_register(&_finder, "image/x-enesim-long",
+			"ENESIM", 6, 0);
+
+	s = enesim_stream_buffer_new(data, sizeof(data), NULL);
+	mime = enesim_image_mime_data_from(s);
+	if (!mime || strcmp(mime, "image/x-enesim-long"))
+	{
+		printf("Wrong mime '%s' found\n", mime);
+		ret = 1;
+	}
+	enesim_stream_unref(s);
+
+	/* the magic numbers go away with the finder */
+	enesim_image_finder_unregister(&_finder);
+	s = enesim_stream_buffer_new(data, sizeof(data), NULL);
+	mime = enesim_image_mime_data_from(s);
+	if (mime)
+	{
+		printf("Mime '%s' found without the finder\n", mime);
+		ret = 1;
+	}
+	enesim_stream_unref(s);
+
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	int ret = 0;
+
+	enesim_init();
+
+	ret |= _test_priority(&_primary, &_marginal);
+	ret |= _test_priority(&_marginal, &_primary);
+	ret |= _test_magic();
+
+	enesim_shutdown();
+
+	return ret;
+}
@@ -0,0 +1,59 @@
+#include "Enesim.h"
+
+int main(int argc, char **argv)
+{
+	Enesim_Pool *pool;
+	Enesim_Surface *surface;
+	unsigned int hits = 0;
+	unsigned int misses = 0;
+	size_t memory = 0;
+
+	enesim_init();
+
+	pool = enesim_pool_recycle_new(4 * 1024 * 1024);
+	if (!pool)
+	{
+		printf("Failed to create the pool\n");
+		return 1;
+	}
+
+	surface = enesim_surface_new_pool_from(ENESIM_FORMAT_ARGB8888, 320, 240,
+			enesim_pool_ref(pool));
+	if (!surface)
+	{
+		printf("Failed to create the surface\n");
+		return 2;
+	}
+	enesim_surface_unref(surface);
+
+	/* a surface of the same size must reuse the freed memory */
+	surface = enesim_surface_new_pool_from(ENESIM_FORMAT_ARGB8888, 320, 240,
+			enesim_pool_ref(pool));
+	if (!surface)
+	{
+		printf("Failed to create the surface\n");
+		return 2;
+	}
+	enesim_surface_unref(surface);
+
+	enesim_pool_recycle_stats_get(pool, &hits, &misses, &memory);
+	if (hits != 1 || misses != 1 || !memory)
+	{
+		printf("Wrong stats %u hits %u misses %zu bytes\n", hits, misses,
+				memory);
+		return 3;
+	}
+
+	enesim_pool_recycle_flush(pool);
+	enesim_pool_recycle_stats_get(pool, NULL, NULL, &memory);
+	if (memory)
+	{
+		printf("Memory not flushed %zu bytes\n", memory);
+		return 4;
+	}
+	enesim_pool_unref(pool);
+
+	enesim_shutdown();
+
+	return 0;
+}
@@ -0,0 +1,70 @@
+#include <string.h>
+#include "Enesim.h"
+
+#define WIDTH 64
+#define HEIGHT 64
+
+/* Blending on a transparent surface must give the same pixels as filling,
+ * even when the solid runs are composed with a renderer color
+ */
+static int _test(const char *name, Enesim_Renderer *r)
+{
+	static uint32_t filled[WIDTH * HEIGHT];
+	static uint32_t blended[WIDTH * HEIGHT];
+	Enesim_Surface *s;
+	int i;
+
+	memset(filled, 0, sizeof(filled));
+	memset(blended, 0, sizeof(blended));
+
+	s = enesim_surface_new_data_from(ENESIM_FORMAT_ARGB8888, WIDTH, HEIGHT,
+			EINA_FALSE, filled, WIDTH * 4, NULL, NULL);
+	enesim_renderer_draw(r, s, ENESIM_ROP_FILL, NULL, 0, 0, NULL);
+	enesim_surface_unref(s);
+
+	s = enesim_surface_new_data_from(ENESIM_FORMAT_ARGB8888, WIDTH, HEIGHT,
+			EINA_FALSE, blended, WIDTH * 4, NULL, NULL);
+	enesim_renderer_draw(r, s, ENESIM_ROP_BLEND, NULL, 0, 0, NULL);
+	enesim_surface_unref(s);
+
+	for (i = 0; i < WIDTH * HEIGHT; i++)
+	{
+		if (filled[i] != blended[i])
+		{
+			printf("%s: pixel %d blended %08x filled %08x\n", name,
+					i, blended[i], filled[i]);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	Enesim_Renderer *r;
+	int ret = 0;
+
+	enesim_init();
+
+	r = enesim_renderer_stripes_new();
+	enesim_renderer_stripes_even_color_set(r, 0xffff0000);
+	enesim_renderer_stripes_odd_color_set(r, 0xff0000ff);
+	enesim_renderer_stripes_even_thickness_set(r, 4);
+	enesim_renderer_stripes_odd_thickness_set(r, 8);
+	enesim_renderer_color_set(r, 0x80808080);
+	ret |= _test("stripes", r);
+	enesim_renderer_unref(r);
+
+	r = enesim_renderer_checker_new();
+	enesim_renderer_checker_even_color_set(r, 0xffff0000);
+	enesim_renderer_checker_odd_color_set(r, 0xff0000ff);
+	enesim_renderer_checker_width_set(r, 5);
+	enesim_renderer_checker_height_set(r, 7);
+	enesim_renderer_color_set(r, 0x80808080);
+	ret |= _test("checker", r);
+	enesim_renderer_unref(r);
+
+	enesim_shutdown();
+
+	return ret;
+}